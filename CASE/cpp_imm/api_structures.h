@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <cstdint>
 
 // 使用 `using` 来避免反复写 std::
 using std::string;
@@ -22,6 +23,11 @@ struct InfluenceParams {
     vector<int> seed_nodes; 
     int neg_num;
     string seed_generation_mode; // <--- 【新增】用于控制种子生成模式 ("IMM" 或 "RANDOM")
+    double relative_error = 0.1; // 最小化模式下自适应采样允许的相对误差
+    string blocking_engine = "RR"; // 阻塞节点选择引擎 ("RR" 或 "DOMINATOR")
+    string blocking_type = "NODE"; // 阻塞对象 ("NODE" 阻塞节点, "EDGE" 删除边)
+    double mc_error = 0.02;        // 自适应蒙特卡洛的允许误差（传播规模为相对误差，节点概率为绝对误差）
+    double mc_confidence = 0.95;   // 自适应蒙特卡洛的置信水平
 };
 
 struct ApiRequest {
@@ -48,6 +54,7 @@ struct ApiResult {
     FinalInfluenceResult final_influence;
     string message;
     vector<Edge> main_propagation_paths;
+    int simulations_used = 0; // 影响力估计实际使用的蒙特卡洛模拟次数
 };
 
 
@@ -61,12 +68,17 @@ struct ApiMinResult {
     string original_result_id;
     string blocked_result_id;
     vector<BlockingNodeResult> blocking_nodes;
+    vector<Edge> blocking_edges; // 边阻塞模式下选出的待删除边
     vector<int> seed_nodes;
     FinalInfluenceResult influence_before;
     FinalInfluenceResult influence_after;
     double reduction_ratio;
     vector<Edge> cut_off_paths; 
     string message;
+    int64_t rr_sample_size = 0;     // 自适应采样最终使用的RR集数量
+    double sample_confidence = 0.0; // 阻塞效果估计落在相对误差内的置信度
+    int simulations_before = 0;     // 阻塞前影响力估计使用的蒙特卡洛模拟次数
+    int simulations_after = 0;      // 阻塞后影响力估计使用的蒙特卡洛模拟次数
 };
 
 
@@ -125,8 +137,9 @@ struct ApiCommunityResult {
 // 代表一条路径和其得分（例如，深度）
 struct CriticalPath {
     vector<int> nodes; // 路径上的节点ID序列
-    double score;      // 路径的得分，这里是深度
-    string type;       // 路径类型, e.g., "deepest"
+    double score;      // 路径的得分："deepest" 为深度，"most_probable" 为经验概率
+    string type;       // 路径类型, e.g., "deepest", "most_probable"
+    double probability; // 经验概率：路径上每条边都是激活边的样本比例
 };
 
 // 封装关键路径分析的完整API返回体
@@ -134,6 +147,53 @@ struct ApiCriticalPathResult {
     string result_id;
     vector<CriticalPath> critical_paths;
     string message;
+    int num_samples;                   // 统计所用的传播样本数
+    vector<double> depth_distribution; // depth_distribution[d]：传播深度为 d 的样本比例
+    double mean_depth;                 // 平均传播深度
+};
+
+// --- 批量影响力评估 ---
+
+// 一个待评估的 (种子, 阻塞) 组合
+struct SpreadQuery {
+    vector<int> seed_nodes;
+    vector<int> blocking_nodes;
+    vector<Edge> blocking_edges; // 删除的边（边阻塞候选方案）
+};
+
+// 单个组合的评估结果
+struct SpreadQueryResult {
+    double total_influence;         // 期望激活节点数（所有概率之和）
+    int active_count;               // 激活概率不低于 0.5 的节点数（只估计总量时为 -1）
+    vector<NodeState> final_states; // 仅在请求逐节点概率时填充
+};
+
+// 批量评估的完整返回体，results 与输入的查询一一对应
+struct ApiBatchSpreadResult {
+    string result_id;
+    vector<SpreadQueryResult> results;
+    int num_worlds;                 // 评估所用的预采样世界数（RR 估计时为 0）
+    string message;
+};
+
+// --- 批量社区搜索 ---
+
+// 所有查询节点的社区。剥离后的候选节点被划分为互不相交的连通分量，因此两个查询节点的社区
+// 要么相同、要么不相交：相同的社区只保存一次，community_queries 给出共享它的查询节点
+struct BatchCommunityResult {
+    vector<CommunityResult> communities;   // 去重后的社区，按首次出现的查询节点排序
+    vector<vector<int>> community_queries; // 每个社区包含的查询节点（重叠信息）
+    vector<int> query_nodes;               // 输入的查询节点（保持原顺序）
+    vector<int> community_of_query;        // 查询节点 -> communities 下标，没有社区（未受影响或被剥离）时为 -1
+};
+
+// 批量社区分析的完整API返回结果
+struct ApiBatchCommunityResult {
+    string result_id;
+    BatchCommunityResult batch;
+    string message;
+    vector<NodeState> final_states;
+    vector<int> seed_nodes;
 };
 
 #endif // API_STRUCTURES_H
\ No newline at end of file
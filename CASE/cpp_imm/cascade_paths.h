@@ -0,0 +1,272 @@
+#ifndef CASCADE_PATHS_H
+#define CASCADE_PATHS_H
+
+#include "world_store.h"
+
+// 多样本传播树统计：在预采样世界上（按层同步的位并行 BFS）得到每个世界的传播树，
+// 汇总每条边作为激活边的次数（边流量）与传播深度的分布，并据此给出流量最大的边和经验概率最大的传播路径。
+// 所有数组都按节点/边ID稠密存放，深度由 BFS 的层号直接得到，不需要递归；内存与世界数无关。
+
+struct CascadeStatistics
+{
+    int num_samples = 0;
+    vector<int64_t> edge_count;  // 边ID -> 该边作为激活边的世界数
+    vector<int64_t> depth_count; // depth_count[d]：传播深度（最深一层的层号）为 d 的世界数
+};
+
+// 一条从种子出发的传播路径，count 为路径上每条边都是激活边的世界数
+struct PropagationPath
+{
+    vector<int> nodes;
+    int64_t count = 0;
+};
+
+inline CascadeStatistics collect_cascade_statistics(
+    const WorldStore &worlds,
+    const InfGraph &g,
+    const vector<int> &initial_nodes,
+    const vector<int> &blocking_nodes = {},
+    const vector<char> &blocked_edges = {},
+    int num_threads = default_num_threads())
+{
+    num_threads = std::max(1, num_threads);
+    vector<vector<int64_t>> edge_counts(num_threads), depth_counts(num_threads);
+    worlds.trace_activations(g, initial_nodes, blocking_nodes, blocked_edges, num_threads,
+        [&](int t, int64_t, int eid, int, int, int, uint64_t hit)
+        {
+            if (edge_counts[t].empty())
+                edge_counts[t].assign(g.m, 0);
+            edge_counts[t][eid] += popcount64(hit);
+        },
+        [&](int t, int64_t, uint64_t, const vector<uint64_t> &level_masks)
+        {
+            // 每个世界的深度是它最后一次出现新激活的层
+            vector<int64_t> &depth = depth_counts[t];
+            if (depth.size() < level_masks.size())
+                depth.resize(level_masks.size(), 0);
+            uint64_t rest = level_masks.empty() ? 0 : level_masks[0];
+            for (int d = (int)level_masks.size() - 1; d >= 0 && rest; --d)
+            {
+                uint64_t deepest = level_masks[d] & rest;
+                depth[d] += popcount64(deepest);
+                rest &= ~deepest;
+            }
+        });
+
+    CascadeStatistics stats;
+    stats.num_samples = worlds.size();
+    stats.edge_count.assign(g.m, 0);
+    for (int t = 0; t < num_threads; ++t)
+    {
+        for (size_t e = 0; e < edge_counts[t].size(); ++e)
+            stats.edge_count[e] += edge_counts[t][e];
+        if (stats.depth_count.size() < depth_counts[t].size())
+            stats.depth_count.resize(depth_counts[t].size(), 0);
+        for (size_t d = 0; d < depth_counts[t].size(); ++d)
+            stats.depth_count[d] += depth_counts[t][d];
+    }
+    return stats;
+}
+
+// 按得分降序取前 top_n 条边的ID（只含得分 > 0 的边，得分相同时边ID小者优先）
+inline vector<int> top_scored_edges(const vector<int64_t> &score, int top_n)
+{
+    vector<int> edges;
+    for (size_t e = 0; e < score.size(); ++e)
+    {
+        if (score[e] > 0)
+            edges.push_back(e);
+    }
+    auto by_score = [&](int a, int b)
+    {
+        return score[a] != score[b] ? score[a] > score[b] : a < b;
+    };
+    const size_t keep = std::min(edges.size(), (size_t)std::max(0, top_n));
+    std::partial_sort(edges.begin(), edges.begin() + keep, edges.end(), by_score);
+    edges.resize(keep);
+    return edges;
+}
+
+// 边流量：edge_count[e] / num_samples 即边 e 作为激活边的经验概率。返回流量最大的前 top_n 条边
+inline vector<int> top_flow_edges(const CascadeStatistics &stats, int top_n)
+{
+    return top_scored_edges(stats.edge_count, top_n);
+}
+
+// 阻塞前后在同一批世界上统计的流量之差，返回流量下降最多的前 top_n 条边（即被阻塞切断的主要传播边）
+inline vector<int> top_flow_drop_edges(const CascadeStatistics &before, const CascadeStatistics &after, int top_n)
+{
+    vector<int64_t> drop(before.edge_count.size(), 0);
+    for (size_t e = 0; e < drop.size(); ++e)
+        drop[e] = before.edge_count[e] - (e < after.edge_count.size() ? after.edge_count[e] : 0);
+    return top_scored_edges(drop, top_n);
+}
+
+// 经验概率最大的传播路径。每个非种子节点取激活次数最多的入边作为“主父边”，主父边构成以种子为根的森林，
+// 候选路径就是森林中从种子到各节点的路径。再在同一批世界上重新追踪一遍，按森林的层序用位运算累计
+// “路径上每条边都是激活边”的世界（路径掩码 = 父路径掩码 & 本边的激活掩码），每批 O(n)。
+// 与某个子路径出现次数相同的路径只是它的前缀，不单独报告。返回按出现次数降序（相同时路径更长者优先）的前 top_k 条；
+// deepest 非空时返回出现过（次数 > 0）的最长候选路径。
+inline vector<PropagationPath> most_probable_paths(
+    const WorldStore &worlds,
+    const InfGraph &g,
+    const vector<int> &initial_nodes,
+    const CascadeStatistics &stats,
+    int top_k,
+    PropagationPath *deepest = nullptr,
+    int num_threads = default_num_threads())
+{
+    const int n = g.n;
+    num_threads = std::max(1, num_threads);
+    vector<char> is_seed(n, 0);
+    for (int s : initial_nodes)
+    {
+        if (s >= 0 && s < n)
+            is_seed[s] = 1;
+    }
+
+    // 1. 主父边
+    vector<int> parent(n, -1), parent_edge(n, -1);
+    for (int v = 0; v < n; ++v)
+    {
+        if (is_seed[v])
+            continue;
+        int64_t best = 0;
+        for (size_t i = 0; i < g.gT[v].size(); ++i)
+        {
+            int e = g.in_eid[v][i];
+            if (stats.edge_count[e] > best)
+            {
+                best = stats.edge_count[e];
+                parent[v] = g.gT[v][i];
+                parent_edge[v] = e;
+            }
+        }
+    }
+
+    // 2. 从种子出发按层序遍历主父边森林（不可从种子到达的节点——主父边成环——不是候选）
+    vector<int> child_offset(n + 1, 0), children(n), order, length(n, 0);
+    for (int v = 0; v < n; ++v)
+    {
+        if (parent[v] != -1)
+            child_offset[parent[v] + 1]++;
+    }
+    for (int v = 0; v < n; ++v)
+        child_offset[v + 1] += child_offset[v];
+    {
+        vector<int> cursor(child_offset.begin(), child_offset.end() - 1);
+        for (int v = 0; v < n; ++v)
+        {
+            if (parent[v] != -1)
+                children[cursor[parent[v]]++] = v;
+        }
+    }
+    for (int v = 0; v < n; ++v)
+    {
+        if (is_seed[v])
+            order.push_back(v);
+    }
+    for (size_t head = 0; head < order.size(); ++head)
+    {
+        int u = order[head];
+        for (int k = child_offset[u]; k < child_offset[u + 1]; ++k)
+        {
+            int v = children[k];
+            length[v] = length[u] + 1;
+            order.push_back(v);
+        }
+    }
+    const size_t num_roots = std::count(is_seed.begin(), is_seed.end(), 1);
+
+    // 3. 在同一批世界上累计每条候选路径的出现次数
+    vector<vector<uint64_t>> activated(num_threads), path_mask(num_threads);
+    vector<vector<int>> touched(num_threads);
+    vector<vector<int64_t>> counts(num_threads);
+    worlds.trace_activations(g, initial_nodes, {}, {}, num_threads,
+        [&](int t, int64_t, int eid, int, int, int, uint64_t hit)
+        {
+            if (activated[t].empty())
+                activated[t].assign(g.m, 0);
+            if (!activated[t][eid])
+                touched[t].push_back(eid);
+            activated[t][eid] |= hit;
+        },
+        [&](int t, int64_t, uint64_t lanes, const vector<uint64_t> &)
+        {
+            vector<uint64_t> &mask = path_mask[t];
+            if (mask.empty())
+            {
+                mask.assign(n, 0);
+                counts[t].assign(n, 0);
+            }
+            if (activated[t].empty())
+                activated[t].assign(g.m, 0);
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                int v = order[i];
+                if (i < num_roots)
+                {
+                    mask[v] = lanes;
+                    continue;
+                }
+                mask[v] = mask[parent[v]] & activated[t][parent_edge[v]];
+                counts[t][v] += popcount64(mask[v]);
+            }
+            for (int e : touched[t])
+                activated[t][e] = 0;
+            touched[t].clear();
+        });
+
+    vector<int64_t> count(n, 0);
+    for (int t = 0; t < num_threads; ++t)
+    {
+        for (size_t v = 0; v < counts[t].size(); ++v)
+            count[v] += counts[t][v];
+    }
+
+    // 4. 去掉被子路径支配的前缀，排序取前 top_k
+    auto build_path = [&](int v)
+    {
+        PropagationPath path;
+        path.count = count[v];
+        for (int x = v; x != -1; x = is_seed[x] ? -1 : parent[x])
+            path.nodes.push_back(x);
+        std::reverse(path.nodes.begin(), path.nodes.end());
+        return path;
+    };
+    vector<int> candidates;
+    int deepest_node = -1;
+    for (size_t i = num_roots; i < order.size(); ++i)
+    {
+        int v = order[i];
+        if (count[v] == 0)
+            continue;
+        if (deepest_node == -1 || length[v] > length[deepest_node] ||
+            (length[v] == length[deepest_node] && count[v] > count[deepest_node]))
+            deepest_node = v;
+        bool dominated = false;
+        for (int k = child_offset[v]; k < child_offset[v + 1] && !dominated; ++k)
+            dominated = (count[children[k]] == count[v]);
+        if (!dominated)
+            candidates.push_back(v);
+    }
+    std::sort(candidates.begin(), candidates.end(), [&](int a, int b)
+    {
+        if (count[a] != count[b])
+            return count[a] > count[b];
+        if (length[a] != length[b])
+            return length[a] > length[b];
+        return a < b;
+    });
+    if ((int)candidates.size() > top_k)
+        candidates.resize(std::max(0, top_k));
+
+    vector<PropagationPath> paths;
+    for (int v : candidates)
+        paths.push_back(build_path(v));
+    if (deepest)
+        *deepest = deepest_node == -1 ? PropagationPath() : build_path(deepest_node);
+    return paths;
+}
+
+#endif // CASCADE_PATHS_H
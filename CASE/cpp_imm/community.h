@@ -3,6 +3,12 @@
 
 #include "infgraph.h"
 #include "api_structures.h"
+#include "local_graph.h"
+#include "parallel_peel.h"
+#include "core_index.h"
+#include "truss_index.h"
+#include "dcore_index.h"
+#include "influence_peel.h"
 #include <numeric>
 #include <algorithm>
 #include <iostream>
@@ -25,70 +31,94 @@ using std::pair; // 【新增】
 class CommunitySearcher {
 private:
     /**
-     * @brief 辅助函数：从有向图 g 和 gT 构建一个局部的、无向的邻接表。
-     * @param g InfGraph 对象
-     * @param node_set 搜索空间内的节点
-     * @return map<int, set<int>> 无向邻接表
+     * @brief 搜索空间：包含查询节点的受影响弱连通区域，以局部 CSR 子图表示
      */
-    static map<int, set<int>> build_undirected_adj(InfGraph& g, const unordered_set<int>& node_set) {
-        map<int, set<int>> adj;
-        for (int u : node_set) {
-            adj[u]; // 确保节点存在
-            // 1. 遍历出邻居
-            for (int v : g.g[u]) {
-                if (node_set.count(v)) {
-                    adj[u].insert(v);
-                    adj[v].insert(u);
-                }
-            }
-            // 2. 遍历入邻居
-            for (int v : g.gT[u]) {
-                if (node_set.count(v)) {
-                    adj[u].insert(v);
-                    adj[v].insert(u);
-                }
-            }
-        }
-        return adj;
-    }
+    struct SearchSpace {
+        LocalGraph lg;                 // 搜索空间的局部子图
+        vector<int> valid_query_nodes; // 受影响的查询节点（局部ID）
+        vector<int> valid_global;      // 受影响的查询节点（全局ID）
+        vector<char> influenced;       // 全局ID -> 是否受影响
+        vector<double> node_probs;     // 全局ID -> 影响概率（未受影响为 0）
+    };
 
     /**
-     * @brief 辅助函数：标准化边（u, v）为 (min, max)
+     * @brief 辅助函数：标记受影响节点并筛选出受影响的查询节点
      */
-    static pair<int, int> make_edge(int u, int v) {
-        return {std::min(u, v), std::max(u, v)};
+    static bool collect_query_nodes(
+        const vector<NodeState>& final_states,
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        SearchSpace& space
+    ) {
+        // 受影响节点用稠密标记数组表示
+        space.influenced.assign(g.n, 0);
+        space.node_probs.assign(g.n, 0.0);
+        for (const auto& ns : final_states) {
+            if (ns.id < 0 || ns.id >= g.n) continue;
+            space.node_probs[ns.id] = ns.probability;
+            space.influenced[ns.id] = 1;
+        }
+
+        for (int qn : query_nodes) {
+            if (qn >= 0 && qn < g.n && space.influenced[qn]) {
+                space.valid_global.push_back(qn);
+            }
+        }
+        std::cout << "[DEBUG] Step 1: Found " << space.valid_global.size() << " valid (influenced) query nodes." << std::endl;
+        if (space.valid_global.empty()) {
+            std::cout << "[DEBUG] FAILURE: No query nodes found in the set of influenced nodes. Aborting." << std::endl;
+            return false;
+        }
+        return true;
     }
 
     /**
-     * @brief 辅助函数：执行BFS来提取连通分量 (用于无向图)
+     * @brief 辅助函数：找到包含第一个查询节点的受影响弱连通区域，只保留满足 keep 的节点构建局部子图。
+     * keep 用于按索引预先排除不可能出现在结果中的节点。all_queries 为真时区域包含所有受影响的查询节点（批量搜索）。
      */
-    static unordered_set<int> extract_connected_component(
-        int start_node,
-        const map<int, set<int>>& adj,
-        const unordered_set<int>& candidates
-    ) {
-        unordered_set<int> component;
-        queue<int> q;
-
-        if (candidates.count(start_node)) {
-            q.push(start_node);
-            component.insert(start_node);
+    template <typename Keep>
+    static void build_search_space(const InfGraph& g, SearchSpace& space, Keep keep, bool all_queries = false) {
+        vector<char> visited(g.n, 0);
+        vector<int> region;
+        const size_t num_sources = all_queries ? space.valid_global.size() : 1;
+        for (size_t i = 0; i < num_sources; ++i) {
+            int source = space.valid_global[i];
+            if (!visited[source]) {
+                visited[source] = 1;
+                region.push_back(source);
+            }
         }
-
-        while (!q.empty()) {
-            int u = q.front();
-            q.pop();
-
-            if (adj.count(u)) {
-                for (int v : adj.at(u)) {
-                    if (candidates.count(v) && !component.count(v)) {
-                        component.insert(v);
-                        q.push(v);
-                    }
+        for (size_t head = 0; head < region.size(); ++head) {
+            int u = region[head];
+            for (int v : g.g[u]) {
+                if (space.influenced[v] && !visited[v]) {
+                    visited[v] = 1;
+                    region.push_back(v);
+                }
+            }
+            for (int v : g.gT[u]) {
+                if (space.influenced[v] && !visited[v]) {
+                    visited[v] = 1;
+                    region.push_back(v);
                 }
             }
         }
-        return component;
+        std::cout << "[DEBUG] Step 2: Identified search space (weakly connected component) with " << region.size() << " nodes." << std::endl;
+
+        size_t kept = 0;
+        for (int v : region) {
+            if (keep(v)) region[kept++] = v;
+        }
+        if (kept < region.size()) {
+            std::cout << "[DEBUG] Step 2: Index pruned the search space to " << kept << " nodes." << std::endl;
+            region.resize(kept);
+        }
+        space.lg.build(g, region);
+        for (int qn : space.valid_global) {
+            if (space.lg.local_of[qn] >= 0) {
+                space.valid_query_nodes.push_back(space.lg.local_of[qn]);
+            }
+        }
     }
 
     /**
@@ -97,72 +127,53 @@ private:
      */
     static bool prepare_search_space(
         const vector<NodeState>& final_states,
-        InfGraph& g,
+        const InfGraph& g,
         const vector<int>& query_nodes,
-        unordered_set<int>& search_space,
-        vector<int>& valid_query_nodes,
-        unordered_map<int, double>& node_probs
+        SearchSpace& space
     ) {
-        // 1. 准备数据
-        unordered_set<int> influenced_nodes;
-        for (const auto& ns : final_states) {
-            node_probs[ns.id] = ns.probability;
-            influenced_nodes.insert(ns.id);
+        if (!collect_query_nodes(final_states, g, query_nodes, space)) {
+            return false;
         }
+        build_search_space(g, space, [](int) { return true; });
+        return true;
+    }
 
-        for (int qn : query_nodes) {
-            if (influenced_nodes.count(qn)) {
-                valid_query_nodes.push_back(qn);
-            }
-        }
-        std::cout << "[DEBUG] Step 1: Found " << valid_query_nodes.size() << " valid (influenced) query nodes." << std::endl;
-        if (valid_query_nodes.empty()) {
-            std::cout << "[DEBUG] FAILURE: No query nodes found in the set of influenced nodes. Aborting." << std::endl;
-            return false;
+    /**
+     * @brief 辅助函数：找到第一个在剥离后幸存的查询节点（局部ID），没有则返回 -1
+     */
+    static int first_surviving_query(const SearchSpace& space, const vector<char>& alive) {
+        for (int qn : space.valid_query_nodes) {
+            if (alive[qn]) return qn;
         }
+        return -1;
+    }
 
-        // 2. 找到包含查询节点的连通子图作为搜索空间 (弱连通)
-        queue<int> q_bfs;
-        q_bfs.push(valid_query_nodes[0]);
-        search_space.insert(valid_query_nodes[0]);
-        
-        while (!q_bfs.empty()) {
-            int u = q_bfs.front();
-            q_bfs.pop();
-            // 检查出边
-            for (int v : g.g[u]) {
-                if (influenced_nodes.count(v) && !search_space.count(v)) {
-                    search_space.insert(v);
-                    q_bfs.push(v);
-                }
-            }
-            // 检查入边
-            for (int v : g.gT[u]) {
-                if (influenced_nodes.count(v) && !search_space.count(v)) {
-                    search_space.insert(v);
-                    q_bfs.push(v);
-                }
-            }
+    /**
+     * @brief 辅助函数：把局部ID的分量转换为全局ID
+     */
+    static vector<int> to_global(const SearchSpace& space, const vector<int>& component) {
+        vector<int> nodes;
+        nodes.reserve(component.size());
+        for (int local : component) {
+            nodes.push_back(space.lg.nodes[local]);
         }
-        std::cout << "[DEBUG] Step 2: Identified search space (weakly connected component) with " << search_space.size() << " nodes." << std::endl;
-        return true;
+        return nodes;
     }
 
     /**
      * @brief 辅助函数：封装最终结果
      */
     static CommunityResult package_result(
-        const unordered_set<int>& final_component,
-        const unordered_map<int, double>& node_probs
+        const vector<int>& final_component,
+        const SearchSpace& space
     ) {
         CommunityResult result;
         double prob_sum = 0.0;
         for (int node : final_component) {
             result.node_ids.push_back(node);
-            if (node_probs.count(node)) {
-                 prob_sum += node_probs.at(node);
-            }
+            prob_sum += space.node_probs[node];
         }
+        std::sort(result.node_ids.begin(), result.node_ids.end());
 
         result.node_count = result.node_ids.size();
         if (result.node_count > 0) {
@@ -175,17 +186,177 @@ private:
     }
 
 
+    /**
+     * @brief 辅助函数：在搜索空间上做 k-core 剥离，返回包含第一个幸存查询节点的连通 k-core（局部ID），失败时为空。
+     * 有索引时只保留全图核数 >= k 的节点。
+     */
+    static vector<int> k_core_component(
+        int k_core,
+        const InfGraph& g,
+        SearchSpace& space,
+        const CoreIndex* core_index
+    ) {
+        // 2. 准备搜索空间（有索引时只保留全图核数 >= k 的节点）
+        if (core_index) {
+            build_search_space(g, space, [&](int v) { return core_index->core_number(v) >= k_core; });
+        } else {
+            build_search_space(g, space, [](int) { return true; });
+        }
+
+        // 3. 【k-core 特定部分】在无向视图上执行桶排序核分解
+        std::cout << "[DEBUG] Step 3: Building undirected view and performing k-core decomposition..." << std::endl;
+        vector<int> core = compute_core_numbers(space.lg.und_offset, space.lg.und_adj, g.num_threads);
+        vector<char> alive(space.lg.size(), 0);
+        int remaining = 0;
+        for (int u = 0; u < space.lg.size(); ++u) {
+            if (core[u] >= k_core) {
+                alive[u] = 1;
+                remaining++;
+            }
+        }
+        std::cout << "[DEBUG] Step 3: ...Decomposition complete. " << remaining << " nodes remain." << std::endl;
+        if (remaining == 0) {
+             std::cout << "[DEBUG] FAILURE: The k-core decomposition removed all nodes." << std::endl;
+             return {};
+        }
+
+        // 4. 找到一个在剥离后幸存的查询节点
+        int surviving_query_node = first_surviving_query(space, alive);
+        if (surviving_query_node == -1) {
+            std::cout << "[DEBUG] FAILURE: No query node survived the k-core peeling process." << std::endl;
+            return {};
+        }
+        std::cout << "[DEBUG] Step 4: Query node " << space.lg.nodes[surviving_query_node] << " survived the peeling." << std::endl;
+
+        // 5. 从幸存节点开始，提取最终的连通 k-core 社区
+        std::cout << "[DEBUG] Step 5: Extracting final connected component from the k-core candidates..." << std::endl;
+        vector<int> component = space.lg.component(surviving_query_node, alive);
+        std::cout << "[DEBUG] Step 5: ...Extraction complete. Final component has " << component.size() << " nodes." << std::endl;
+        return component;
+    }
+
+    /**
+     * @brief 辅助函数：在搜索空间上做 k-truss 剥离，返回包含第一个幸存查询节点的连通 k-truss（局部ID），失败时为空。
+     * edge_alive 返回剥离后幸存边的标记；有索引时只保留存在 trussness >= k 关联边的节点。
+     */
+    static vector<int> k_truss_component(
+        int k_truss,
+        const InfGraph& g,
+        SearchSpace& space,
+        const TrussIndex* truss_index,
+        vector<char>& edge_alive
+    ) {
+        const int min_support = k_truss - 2;
+
+        // 2. 准备搜索空间（有索引时只保留存在 trussness >= k 关联边的节点）
+        if (truss_index) {
+            build_search_space(g, space, [&](int v) { return truss_index->node_truss_number(v) >= k_truss; });
+        } else {
+            build_search_space(g, space, [](int) { return true; });
+        }
+
+        // 3. 【k-truss 特定部分】计算三角支持度并剥离边
+        std::cout << "[DEBUG] Step 3: Calculating triangle supports and peeling edges..." << std::endl;
+        edge_alive = compute_k_truss(space.lg, min_support, g.num_threads);
+        vector<char> node_alive(space.lg.size(), 0);
+        int remaining_edges = 0;
+        for (int e = 0; e < space.lg.num_edges(); ++e) {
+            if (!edge_alive[e]) continue;
+            remaining_edges++;
+            node_alive[space.lg.edge_u[e]] = 1;
+            node_alive[space.lg.edge_v[e]] = 1;
+        }
+        int remaining = std::count(node_alive.begin(), node_alive.end(), 1);
+        std::cout << "[DEBUG] Step 3: ...Decomposition complete. " << remaining_edges << " edges remain." << std::endl;
+        std::cout << "[DEBUG] Step 4: " << remaining << " nodes remain in the k-truss." << std::endl;
+        if (remaining == 0) {
+             std::cout << "[DEBUG] FAILURE: The k-truss decomposition removed all nodes." << std::endl;
+             return {};
+        }
+        
+        // 5. 找到一个在剥离后幸存的查询节点
+        int surviving_query_node = first_surviving_query(space, node_alive);
+        if (surviving_query_node == -1) {
+            std::cout << "[DEBUG] FAILURE: No query node survived the k-truss peeling process." << std::endl;
+            return {};
+        }
+        std::cout << "[DEBUG] Step 5: Query node " << space.lg.nodes[surviving_query_node] << " survived the peeling." << std::endl;
+
+        // 6. 从幸存节点开始，沿幸存的边提取最终的连通 k-truss 社区
+        std::cout << "[DEBUG] Step 6: Extracting final connected component from the k-truss candidates..." << std::endl;
+        vector<int> component = space.lg.edge_component(surviving_query_node, edge_alive);
+        std::cout << "[DEBUG] Step 6: ...Extraction complete. Final component has " << component.size() << " nodes." << std::endl;
+        
+        return component;
+    }
+
+    /**
+     * @brief 辅助函数：批量搜索的标记过程。从每个查询节点出发，只沿幸存节点（edge_alive 非空时只沿幸存边）
+     * 做 BFS，每个幸存节点最多被访问一次；已被标记的查询节点直接复用所在社区。
+     */
+    static BatchCommunityResult label_communities(
+        const SearchSpace& space,
+        const vector<int>& query_nodes,
+        const vector<char>& alive,
+        const vector<char>* edge_alive
+    ) {
+        const LocalGraph& lg = space.lg;
+        BatchCommunityResult result;
+        result.query_nodes = query_nodes;
+        result.community_of_query.assign(query_nodes.size(), -1);
+
+        vector<int> label(lg.size(), -1), comp;
+        for (size_t i = 0; i < query_nodes.size(); ++i) {
+            int qn = query_nodes[i];
+            if (qn < 0 || qn >= (int)space.influenced.size() || !space.influenced[qn]) continue;
+            int start = qn < (int)lg.local_of.size() ? lg.local_of[qn] : -1;
+            if (start < 0 || !alive[start]) continue;
+
+            if (label[start] == -1) {
+                comp.assign(1, start);
+                label[start] = result.communities.size();
+                for (size_t head = 0; head < comp.size(); ++head) {
+                    int u = comp[head];
+                    for (int k = lg.und_offset[u]; k < lg.und_offset[u + 1]; ++k) {
+                        int v = lg.und_adj[k];
+                        bool linked = edge_alive ? (*edge_alive)[lg.und_eid[k]] : alive[v];
+                        if (linked && label[v] == -1) {
+                            label[v] = label[start];
+                            comp.push_back(v);
+                        }
+                    }
+                }
+                result.communities.push_back(package_result(to_global(space, comp), space));
+                result.community_queries.emplace_back();
+            }
+            result.community_of_query[i] = label[start];
+            result.community_queries[label[start]].push_back(qn);
+        }
+        std::cout << "[DEBUG] Batch: " << result.communities.size() << " distinct communities for " << query_nodes.size() << " query nodes." << std::endl;
+        return result;
+    }
+
+    static BatchCommunityResult empty_batch(const vector<int>& query_nodes) {
+        BatchCommunityResult result;
+        result.query_nodes = query_nodes;
+        result.community_of_query.assign(query_nodes.size(), -1);
+        return result;
+    }
+
 public:
     /**
      * @brief [DIRECTED VERSION] 查找 (k, l)-core 社区。
-     * (这是您现有的函数，保持不变)
+     * 在搜索空间的局部子图上反复删除内部入度 < k 或出度 < l 的节点，再提取包含查询节点的弱连通分量。
+     * 可选的 dcore_index 为全图的 D-core 索引：子图的 (k,l)-core 包含在全图的 (k,l)-core 中，因此不在后者中的
+     * 节点可以在剥离前直接排除；若第一个查询节点在全图中的弱连通 (k,l)-core 完全受影响，它就是答案。
      */
     static CommunityResult find_most_influenced_community_local(
         int k_core,
         int l_core, 
         const vector<NodeState>& final_states,
-        InfGraph& g,
-        const vector<int>& query_nodes
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        const DCoreIndex* dcore_index = nullptr
     ) {
         std::cout << "\n[DEBUG] --- Starting Community Search (Directed (k,l)-core Mode) ---" << std::endl;
         std::cout << "[DEBUG] k(in-degree)=" << k_core << ", l(out-degree)=" << l_core << ", Influenced Nodes=" << final_states.size() << ", Query Nodes=" << query_nodes.size() << std::endl;
@@ -195,125 +366,58 @@ public:
             return {{}, 0.0, 0};
         }
 
-        // 1. & 2. 准备搜索空间和查询节点
-        unordered_set<int> search_space;
-        vector<int> valid_query_nodes;
-        unordered_map<int, double> node_probs;
-        if (!prepare_search_space(final_states, g, query_nodes, search_space, valid_query_nodes, node_probs)) {
+        // 1. 筛选受影响的查询节点
+        SearchSpace space;
+        if (!collect_query_nodes(final_states, g, query_nodes, space)) {
              return {{}, 0.0, 0};
         }
-        
-        // 3. 【(k, l)-core 特定部分】执行 (k, l)-core 分解
-        std::cout << "[DEBUG] Step 3: Performing (k, l)-core decomposition (peeling)..." << std::endl;
-        unordered_set<int> k_l_core_candidates = search_space;
-        queue<int> removal_q;
-        unordered_map<int, int> internal_in_degrees;
-        unordered_map<int, int> internal_out_degrees;
-
-        // 计算初始的内部入度和出度
-        for (int u : k_l_core_candidates) {
-            int in_degree = 0;
-            for (int v : g.gT[u]) { // gT是转置图，gT[u]是u的入邻居
-                 if(k_l_core_candidates.count(v)) in_degree++;
-            }
-            internal_in_degrees[u] = in_degree;
 
-            int out_degree = 0;
-            for (int v : g.g[u]) { // g是原图，g[u]是u的出邻居
-                 if(k_l_core_candidates.count(v)) out_degree++;
+        if (dcore_index) {
+            // 索引快速路径：全图中包含第一个查询节点的弱连通 (k, l)-core 全部受影响时，
+            // 它同时是受影响区域内包含该节点的弱连通 (k, l)-core，无需剥离
+            vector<int> indexed = dcore_index->community(space.valid_global[0], k_core, l_core);
+            bool all_influenced = !indexed.empty();
+            for (size_t i = 0; i < indexed.size() && all_influenced; ++i) {
+                all_influenced = space.influenced[indexed[i]];
             }
-            internal_out_degrees[u] = out_degree;
-
-            if (in_degree < k_core || out_degree < l_core) {
-                removal_q.push(u);
+            if (all_influenced) {
+                std::cout << "[DEBUG] Step 2: D-core index answered the query directly (" << indexed.size() << " nodes)." << std::endl;
+                return package_result(indexed, space);
             }
         }
-        
-        unordered_set<int> already_in_removal_q;
-        queue<int> temp_q = removal_q;
-        while(!temp_q.empty()){
-            already_in_removal_q.insert(temp_q.front());
-            temp_q.pop();
-        }
-
-        // 开始迭代剥离
-        while (!removal_q.empty()) {
-            int u = removal_q.front();
-            removal_q.pop();
-            
-            if (!k_l_core_candidates.count(u)) continue;
-            k_l_core_candidates.erase(u);
-
-            // 1. 更新 u 的【入邻居】们的【出度】
-            for (int v : g.gT[u]) {
-                if (k_l_core_candidates.count(v)) {
-                    internal_out_degrees[v]--;
-                    if (internal_out_degrees[v] < l_core && !already_in_removal_q.count(v)) {
-                       removal_q.push(v);
-                       already_in_removal_q.insert(v);
-                    }
-                }
-            }
-            // 2. 更新 u 的【出邻居】们的【入度】
-            for (int v : g.g[u]) {
-                if (k_l_core_candidates.count(v)) {
-                    internal_in_degrees[v]--;
-                    if (internal_in_degrees[v] < k_core && !already_in_removal_q.count(v)) {
-                       removal_q.push(v);
-                       already_in_removal_q.insert(v);
-                    }
-                }
-            }
+
+        // 2. 准备搜索空间（有索引时只保留全图 (k, l)-core 中的节点）
+        if (dcore_index) {
+            build_search_space(g, space, [&](int v) { return dcore_index->in_kl_core(v, k_core, l_core); });
+        } else {
+            build_search_space(g, space, [](int) { return true; });
         }
-        std::cout << "[DEBUG] Step 3: ...Decomposition complete. " << k_l_core_candidates.size() << " nodes remain." << std::endl;
-        if (k_l_core_candidates.empty()) {
+        
+        // 3. 【(k, l)-core 特定部分】执行 (k, l)-core 分解
+        std::cout << "[DEBUG] Step 3: Performing (k, l)-core decomposition (peeling)..." << std::endl;
+        vector<char> alive = peel_kl_core(space.lg, k_core, l_core);
+        int remaining = std::count(alive.begin(), alive.end(), 1);
+        std::cout << "[DEBUG] Step 3: ...Decomposition complete. " << remaining << " nodes remain." << std::endl;
+        if (remaining == 0) {
              std::cout << "[DEBUG] FAILURE: The (k, l)-core decomposition removed all nodes in the search space." << std::endl;
              return {{}, 0.0, 0};
         }
         
         // 4. 找到一个在剥离后幸存的查询节点
-        int surviving_query_node = -1;
-        for (int qn : valid_query_nodes) {
-            if (k_l_core_candidates.count(qn)) {
-                surviving_query_node = qn;
-                break;
-            }
-        }
-
+        int surviving_query_node = first_surviving_query(space, alive);
         if (surviving_query_node == -1) {
             std::cout << "[DEBUG] FAILURE: No query node survived the (k, l)-core peeling process." << std::endl;
             return {{}, 0.0, 0};
         }
-        std::cout << "[DEBUG] Step 4: Query node " << surviving_query_node << " survived the peeling." << std::endl;
+        std::cout << "[DEBUG] Step 4: Query node " << space.lg.nodes[surviving_query_node] << " survived the peeling." << std::endl;
 
-        // 5. 从幸存节点开始，提取最终的连通 (k, l)-core 社区 (这里使用有向图的边)
+        // 5. 从幸存节点开始，提取最终的连通 (k, l)-core 社区（出入边都视为相连，即弱连通）
         std::cout << "[DEBUG] Step 5: Extracting final connected component from the (k, l)-core candidates..." << std::endl;
-        unordered_set<int> final_k_l_core_component;
-        queue<int> q_conn;
-        q_conn.push(surviving_query_node);
-        final_k_l_core_component.insert(surviving_query_node);
-
-        while (!q_conn.empty()) {
-            int u = q_conn.front();
-            q_conn.pop();
-            // 再次进行双向搜索，确保弱连通性
-            for (int v : g.g[u]) {
-                if (k_l_core_candidates.count(v) && !final_k_l_core_component.count(v)) {
-                    final_k_l_core_component.insert(v);
-                    q_conn.push(v);
-                }
-            }
-            for (int v : g.gT[u]) {
-                if (k_l_core_candidates.count(v) && !final_k_l_core_component.count(v)) {
-                    final_k_l_core_component.insert(v);
-                    q_conn.push(v);
-                }
-            }
-        }
-        std::cout << "[DEBUG] Step 5: ...Extraction complete. Final component has " << final_k_l_core_component.size() << " nodes." << std::endl;
+        vector<int> component = space.lg.component(surviving_query_node, alive);
+        std::cout << "[DEBUG] Step 5: ...Extraction complete. Final component has " << component.size() << " nodes." << std::endl;
         
         // 6. 封装并返回最终结果
-        return package_result(final_k_l_core_component, node_probs);
+        return package_result(to_global(space, component), space);
     }
 
     // ==========================================================
@@ -323,21 +427,24 @@ public:
      * @brief [UNDIRECTED VERSION] 在有影响力的节点中，查找一个包含查询节点的、连通的 k-core 社区。
      *
      * 1.  **识别搜索空间**: (同上)
-     * 2.  **构建无向视图**: 将搜索空间内的 g.g 和 g.gT 视为无向边，构建邻接表。
-     * 3.  **k-core 分解**: 迭代地移除所有无向度数 < k 的节点。
+     * 2.  **构建无向视图**: 将搜索空间内的 g.g 和 g.gT 视为无向边，构建局部 CSR。
+     * 3.  **k-core 分解**: 按度数桶排序计算核数，保留核数 >= k 的节点。
      * 4.  **提取最终社区**: (同上)
      *
      * @param k_core 社区节点的最小内部【无向度数】约束 (k)。
      * @param final_states 所有受影响节点及其影响概率的列表。
      * @param g 图结构 (g.g 和 g.gT 将被共同用于构建无向视图)。
      * @param query_nodes 用于定位社区的种子节点。
+     * @param core_index 可选的全图核分解索引。子图中的核数不会超过全图核数，因此全图核数 < k 的节点
+     *                   可以在剥离前直接排除；若第一个查询节点在全图中的连通 k-core 完全受影响，它就是答案。
      * @return CommunityResult 找到的最佳 k-core 社区。
      */
     static CommunityResult find_k_core_community(
         int k_core,
         const vector<NodeState>& final_states,
-        InfGraph& g,
-        const vector<int>& query_nodes
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        const CoreIndex* core_index = nullptr
     ) {
         std::cout << "\n[DEBUG] --- Starting Community Search (Undirected k-core Mode) ---" << std::endl;
         std::cout << "[DEBUG] k(undirected-degree)=" << k_core << ", Influenced Nodes=" << final_states.size() << ", Query Nodes=" << query_nodes.size() << std::endl;
@@ -347,88 +454,34 @@ public:
             return {{}, 0.0, 0};
         }
 
-        // 1. & 2. 准备搜索空间和查询节点
-        unordered_set<int> search_space;
-        vector<int> valid_query_nodes;
-        unordered_map<int, double> node_probs;
-        if (!prepare_search_space(final_states, g, query_nodes, search_space, valid_query_nodes, node_probs)) {
+        // 1. 筛选受影响的查询节点
+        SearchSpace space;
+        if (!collect_query_nodes(final_states, g, query_nodes, space)) {
              return {{}, 0.0, 0};
         }
 
-        // 3. 【k-core 特定部分】构建无向视图并执行 k-core 分解
-        std::cout << "[DEBUG] Step 3: Building undirected view and performing k-core decomposition..." << std::endl;
-        map<int, set<int>> undirected_adj = build_undirected_adj(g, search_space);
-        unordered_set<int> k_core_candidates = search_space;
-        
-        queue<int> removal_q;
-        unordered_map<int, int> internal_degrees;
-
-        // 计算初始内部无向度数
-        for (int u : k_core_candidates) {
-            internal_degrees[u] = undirected_adj[u].size();
-            if (internal_degrees[u] < k_core) {
-                removal_q.push(u);
-            }
-        }
-
-        unordered_set<int> already_in_removal_q;
-        queue<int> temp_q = removal_q;
-        while(!temp_q.empty()){
-            already_in_removal_q.insert(temp_q.front());
-            temp_q.pop();
-        }
-
-        // 开始迭代剥离
-        while (!removal_q.empty()) {
-            int u = removal_q.front();
-            removal_q.pop();
-
-            if (!k_core_candidates.count(u)) continue;
-            k_core_candidates.erase(u);
-
-            // 当 u 被移除时，更新其邻居的内部度数
-            for (int v : undirected_adj[u]) {
-                if (k_core_candidates.count(v)) {
-                    internal_degrees[v]--;
-                    if (internal_degrees[v] < k_core && !already_in_removal_q.count(v)) {
-                        removal_q.push(v);
-                        already_in_removal_q.insert(v);
-                    }
-                }
+        if (core_index) {
+            // 索引快速路径：全图中包含第一个查询节点的连通 k-core 全部受影响时，
+            // 它同时是受影响区域内包含该节点的连通 k-core，无需剥离
+            vector<int> indexed = core_index->community(space.valid_global[0], k_core);
+            bool all_influenced = !indexed.empty();
+            for (size_t i = 0; i < indexed.size() && all_influenced; ++i) {
+                all_influenced = space.influenced[indexed[i]];
             }
-        }
-        std::cout << "[DEBUG] Step 3: ...Decomposition complete. " << k_core_candidates.size() << " nodes remain." << std::endl;
-        if (k_core_candidates.empty()) {
-             std::cout << "[DEBUG] FAILURE: The k-core decomposition removed all nodes." << std::endl;
-             return {{}, 0.0, 0};
-        }
-
-        // 4. 找到一个在剥离后幸存的查询节点
-        int surviving_query_node = -1;
-        for (int qn : valid_query_nodes) {
-            if (k_core_candidates.count(qn)) {
-                surviving_query_node = qn;
-                break;
+            if (all_influenced) {
+                std::cout << "[DEBUG] Step 2: Core index answered the query directly (" << indexed.size() << " nodes)." << std::endl;
+                return package_result(indexed, space);
             }
         }
 
-        if (surviving_query_node == -1) {
-            std::cout << "[DEBUG] FAILURE: No query node survived the k-core peeling process." << std::endl;
+        // 2. - 5. 剥离并提取包含查询节点的连通 k-core
+        vector<int> component = k_core_component(k_core, g, space, core_index);
+        if (component.empty()) {
             return {{}, 0.0, 0};
         }
-        std::cout << "[DEBUG] Step 4: Query node " << surviving_query_node << " survived the peeling." << std::endl;
-
-        // 5. 从幸存节点开始，提取最终的连通 k-core 社区 (使用无向邻接表)
-        std::cout << "[DEBUG] Step 5: Extracting final connected component from the k-core candidates..." << std::endl;
-        unordered_set<int> final_k_core_component = extract_connected_component(
-            surviving_query_node, 
-            undirected_adj, 
-            k_core_candidates
-        );
-        std::cout << "[DEBUG] Step 5: ...Extraction complete. Final component has " << final_k_core_component.size() << " nodes." << std::endl;
 
         // 6. 封装并返回最终结果
-        return package_result(final_k_core_component, node_probs);
+        return package_result(to_global(space, component), space);
     }
 
     // ==========================================================
@@ -440,22 +493,26 @@ public:
     * k-truss 是一种更紧密的社区结构，其中每条边都至少是 (k-2) 个三角形的一部分。
     *
     * 1.  **识别搜索空间**: (同上)
-    * 2.  **构建无向视图**: (同上)
-    * 3.  **计算三角支持度**: 计算视图中每条边的“支持度”（即它所属的三角形数量）。
+    * 2.  **构建无向视图**: (同上)，每条无向边有一个稠密的边ID。
+    * 3.  **计算三角支持度**: 对每条边的两个有序邻接表归并求交，得到它所属的三角形数量。
     * 4.  **k-truss 分解**: 迭代地移除所有支持度 < (k-2) 的*边*。当一条边被移除时，它所支持的其他边的支持度也会降低，可能引发连锁移除。
-    * 5.  **提取最终社区**: (同上)
+    * 5.  **提取最终社区**: 从查询节点出发，只沿幸存的边扩展。
     *
     * @param k_truss trussness约束 (k)。k=2 是一般图，k=3 要求每条边至少在一个三角形中。
     * @param final_states 所有受影响节点及其影响概率的列表。
     * @param g 图结构 (g.g 和 g.gT 将被共同用于构建无向视图)。
     * @param query_nodes 用于定位社区的种子节点。
+    * @param truss_index 可选的全图 truss 分解索引。子图中边的 trussness 不会超过全图中的值，因此没有
+    *                    trussness >= k 关联边的节点可以在剥离前直接排除；若第一个查询节点在全图中的连通
+    *                    k-truss 完全受影响，它就是答案。
     * @return CommunityResult 找到的最佳 k-truss 社区。
     */
     static CommunityResult find_k_truss_community(
         int k_truss,
         const vector<NodeState>& final_states,
-        InfGraph& g,
-        const vector<int>& query_nodes
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        const TrussIndex* truss_index = nullptr
     ) {
         std::cout << "\n[DEBUG] --- Starting Community Search (Undirected k-truss Mode) ---" << std::endl;
         std::cout << "[DEBUG] k(trussness)=" << k_truss << ", Influenced Nodes=" << final_states.size() << ", Query Nodes=" << query_nodes.size() << std::endl;
@@ -464,141 +521,251 @@ public:
             std::cout << "[DEBUG] FAILURE: Input state is empty or k < 2. Aborting." << std::endl;
             return {{}, 0.0, 0};
         }
-        const int min_support = k_truss - 2;
 
-        // 1. & 2. 准备搜索空间和查询节点
-        unordered_set<int> search_space;
-        vector<int> valid_query_nodes;
-        unordered_map<int, double> node_probs;
-        if (!prepare_search_space(final_states, g, query_nodes, search_space, valid_query_nodes, node_probs)) {
+        // 1. 筛选受影响的查询节点
+        SearchSpace space;
+        if (!collect_query_nodes(final_states, g, query_nodes, space)) {
              return {{}, 0.0, 0};
         }
 
-        // 3. 【k-truss 特定部分】构建无向视图
-        std::cout << "[DEBUG] Step 3: Building undirected view..." << std::endl;
-        map<int, set<int>> undirected_adj = build_undirected_adj(g, search_space);
-
-        // 4. 计算三角支持度
-        std::cout << "[DEBUG] Step 4: Calculating triangle supports..." << std::endl;
-        map<pair<int, int>, int> edge_supports;
-        // (用于加速剥离) 存储形成三角形的第三个节点
-        map<pair<int, int>, vector<int>> triangle_witnesses; 
-        set<pair<int, int>> current_edges;
-
-        for (const auto& entry : undirected_adj) {
-            int u = entry.first;
-            vector<int> neighbors(entry.second.begin(), entry.second.end());
-            for (size_t i = 0; i < neighbors.size(); ++i) {
-                for (size_t j = i + 1; j < neighbors.size(); ++j) {
-                    int v = neighbors[i];
-                    int w = neighbors[j];
-                    // 检查 (v, w) 是否是边
-                    if (undirected_adj[v].count(w)) {
-                        // 发现三角形 (u, v, w)
-                        pair<int, int> e_uv = make_edge(u, v);
-                        pair<int, int> e_uw = make_edge(u, w);
-                        pair<int, int> e_vw = make_edge(v, w);
-                        
-                        edge_supports[e_uv]++;
-                        edge_supports[e_uw]++;
-                        edge_supports[e_vw]++;
-
-                        triangle_witnesses[e_uv].push_back(w);
-                        triangle_witnesses[e_uw].push_back(v);
-                        triangle_witnesses[e_vw].push_back(u);
-
-                        current_edges.insert(e_uv);
-                        current_edges.insert(e_uw);
-                        current_edges.insert(e_vw);
-                    }
-                }
+        if (truss_index) {
+            // 索引快速路径：全图中包含第一个查询节点的连通 k-truss 全部受影响时，
+            // 它同时是受影响区域内包含该节点的连通 k-truss，无需计算三角形
+            vector<int> indexed = truss_index->community(space.valid_global[0], k_truss);
+            bool all_influenced = !indexed.empty();
+            for (size_t i = 0; i < indexed.size() && all_influenced; ++i) {
+                all_influenced = space.influenced[indexed[i]];
+            }
+            if (all_influenced) {
+                std::cout << "[DEBUG] Step 2: Truss index answered the query directly (" << indexed.size() << " nodes)." << std::endl;
+                return package_result(indexed, space);
             }
         }
-        std::cout << "[DEBUG] Step 4: ...Found " << current_edges.size() << " edges in " << edge_supports.size() << " triangles." << std::endl;
 
-        // 5. 执行 k-truss (边) 剥离
-        std::cout << "[DEBUG] Step 5: Performing k-truss decomposition (peeling edges)..." << std::endl;
-        queue<pair<int, int>> removal_q;
-        for (const auto& edge : current_edges) {
-            if (edge_supports[edge] < min_support) {
-                removal_q.push(edge);
-            }
+        // 2. - 6. 剥离并提取包含查询节点的连通 k-truss
+        vector<char> edge_alive;
+        vector<int> component = k_truss_component(k_truss, g, space, truss_index, edge_alive);
+        if (component.empty()) {
+            return {{}, 0.0, 0};
         }
 
-        while (!removal_q.empty()) {
-            pair<int, int> edge_uv = removal_q.front();
-            removal_q.pop();
+        // 7. 封装并返回最终结果
+        return package_result(to_global(space, component), space);
+    }
 
-            if (!current_edges.count(edge_uv)) continue; // 已经被移除了
-            current_edges.erase(edge_uv);
+    // ==========================================================
+    // 影响力加权的社区搜索
+    // ==========================================================
+    /**
+     * @brief [UNDIRECTED VERSION] 在满足 k-core 约束的前提下，查找平均影响概率最大的、包含查询节点的连通社区。
+     *
+     * 以 find_k_core_community 找到的连通 k-core 为初始社区，受影响的查询节点作为锚点始终保留；
+     * 之后按概率从低到高贪心删除节点（删除会连锁删除锚点的节点跳过），从剥离过程中的各个状态里
+     * 选出平均概率最大者（见 influence_peel.h）。
+     *
+     * @param k_core 社区节点的最小内部【无向度数】约束 (k)。
+     * @param core_index 可选的全图核分解索引，用于剥离前排除核数 < k 的节点。
+     * @return CommunityResult 平均影响概率最大的 k-core 社区。
+     */
+    static CommunityResult find_influential_k_core_community(
+        int k_core,
+        const vector<NodeState>& final_states,
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        const CoreIndex* core_index = nullptr
+    ) {
+        std::cout << "\n[DEBUG] --- Starting Community Search (Influence-weighted k-core Mode) ---" << std::endl;
+        std::cout << "[DEBUG] k(undirected-degree)=" << k_core << ", Influenced Nodes=" << final_states.size() << ", Query Nodes=" << query_nodes.size() << std::endl;
 
-            int u = edge_uv.first;
-            int v = edge_uv.second;
+        if (final_states.empty() || k_core < 0) {
+            std::cout << "[DEBUG] FAILURE: Input state is empty or k is negative. Aborting." << std::endl;
+            return {{}, 0.0, 0};
+        }
 
-            // 遍历所有 (u, v, w) 三角形
-            for (int w : triangle_witnesses[edge_uv]) {
-                pair<int, int> edge_uw = make_edge(u, w);
-                pair<int, int> edge_vw = make_edge(v, w);
+        // 1. - 5. 找到包含查询节点的连通 k-core 作为初始社区
+        SearchSpace space;
+        if (!collect_query_nodes(final_states, g, query_nodes, space)) {
+             return {{}, 0.0, 0};
+        }
+        vector<int> component = k_core_component(k_core, g, space, core_index);
+        if (component.empty()) {
+            return {{}, 0.0, 0};
+        }
 
-                // 检查边 (u, w)
-                if (current_edges.count(edge_uw)) {
-                    edge_supports[edge_uw]--;
-                    if (edge_supports[edge_uw] < min_support) {
-                        removal_q.push(edge_uw);
-                    }
-                }
-                // 检查边 (v, w)
-                if (current_edges.count(edge_vw)) {
-                    edge_supports[edge_vw]--;
-                    if (edge_supports[edge_vw] < min_support) {
-                        removal_q.push(edge_vw);
-                    }
-                }
-            }
+        // 6. 在初始社区内按影响概率贪心剥离
+        vector<char> in_community(space.lg.size(), 0);
+        for (int v : component) in_community[v] = 1;
+        vector<int> anchors;
+        for (int qn : space.valid_query_nodes) {
+            if (in_community[qn]) anchors.push_back(qn);
+        }
+        vector<double> prob(space.lg.size());
+        for (int v = 0; v < space.lg.size(); ++v) {
+            prob[v] = space.node_probs[space.lg.nodes[v]];
         }
-        std::cout << "[DEBUG] Step 5: ...Decomposition complete. " << current_edges.size() << " edges remain." << std::endl;
+        std::cout << "[DEBUG] Step 6: Peeling low-influence nodes from " << component.size() << " nodes with " << anchors.size() << " anchors..." << std::endl;
+        vector<int> best = peel_max_average_core(space.lg, prob, in_community, k_core, anchors);
+        std::cout << "[DEBUG] Step 6: ...Peeling complete. Best community has " << best.size() << " nodes." << std::endl;
+
+        // 7. 封装并返回最终结果
+        return package_result(to_global(space, best), space);
+    }
 
-        // 6. 从幸存的边中提取节点
-        unordered_set<int> k_truss_candidates;
-        map<int, set<int>> k_truss_adj; // 幸存的图结构
-        for (const auto& edge : current_edges) {
-            k_truss_candidates.insert(edge.first);
-            k_truss_candidates.insert(edge.second);
-            k_truss_adj[edge.first].insert(edge.second);
-            k_truss_adj[edge.second].insert(edge.first);
+    /**
+     * @brief [UNDIRECTED VERSION] 在满足 k-truss 约束的前提下，查找平均影响概率最大的、包含查询节点的连通社区。
+     *
+     * 以 find_k_truss_community 找到的连通 k-truss 为初始社区，其余同 find_influential_k_core_community；
+     * 删除节点即删除它的全部关联边，支持度不足的边连锁删除，失去所有边的节点离开社区。
+     *
+     * @param k_truss trussness约束 (k >= 2)。
+     * @param truss_index 可选的全图 truss 分解索引，用于剥离前排除没有 trussness >= k 关联边的节点。
+     * @return CommunityResult 平均影响概率最大的 k-truss 社区。
+     */
+    static CommunityResult find_influential_k_truss_community(
+        int k_truss,
+        const vector<NodeState>& final_states,
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        const TrussIndex* truss_index = nullptr
+    ) {
+        std::cout << "\n[DEBUG] --- Starting Community Search (Influence-weighted k-truss Mode) ---" << std::endl;
+        std::cout << "[DEBUG] k(trussness)=" << k_truss << ", Influenced Nodes=" << final_states.size() << ", Query Nodes=" << query_nodes.size() << std::endl;
+
+        if (final_states.empty() || k_truss < 2) {
+            std::cout << "[DEBUG] FAILURE: Input state is empty or k < 2. Aborting." << std::endl;
+            return {{}, 0.0, 0};
         }
-        std::cout << "[DEBUG] Step 6: " << k_truss_candidates.size() << " nodes remain in the k-truss." << std::endl;
-         if (k_truss_candidates.empty()) {
-             std::cout << "[DEBUG] FAILURE: The k-truss decomposition removed all nodes." << std::endl;
+
+        // 1. - 6. 找到包含查询节点的连通 k-truss 作为初始社区
+        SearchSpace space;
+        if (!collect_query_nodes(final_states, g, query_nodes, space)) {
              return {{}, 0.0, 0};
         }
-        
-        // 7. 找到一个在剥离后幸存的查询节点
-        int surviving_query_node = -1;
-        for (int qn : valid_query_nodes) {
-            if (k_truss_candidates.count(qn)) {
-                surviving_query_node = qn;
-                break;
-            }
+        vector<char> edge_alive;
+        vector<int> component = k_truss_component(k_truss, g, space, truss_index, edge_alive);
+        if (component.empty()) {
+            return {{}, 0.0, 0};
         }
 
-        if (surviving_query_node == -1) {
-            std::cout << "[DEBUG] FAILURE: No query node survived the k-truss peeling process." << std::endl;
-            return {{}, 0.0, 0};
+        // 7. 只保留初始社区内的边，在其上按影响概率贪心剥离
+        vector<char> in_community(space.lg.size(), 0);
+        for (int v : component) in_community[v] = 1;
+        for (int e = 0; e < space.lg.num_edges(); ++e) {
+            if (!in_community[space.lg.edge_u[e]]) edge_alive[e] = 0;
+        }
+        vector<int> anchors;
+        for (int qn : space.valid_query_nodes) {
+            if (in_community[qn]) anchors.push_back(qn);
+        }
+        vector<double> prob(space.lg.size());
+        for (int v = 0; v < space.lg.size(); ++v) {
+            prob[v] = space.node_probs[space.lg.nodes[v]];
         }
-        std::cout << "[DEBUG] Step 7: Query node " << surviving_query_node << " survived the peeling." << std::endl;
+        std::cout << "[DEBUG] Step 7: Peeling low-influence nodes from " << component.size() << " nodes with " << anchors.size() << " anchors..." << std::endl;
+        vector<int> best = peel_max_average_truss(space.lg, prob, edge_alive, k_truss - 2, anchors);
+        std::cout << "[DEBUG] Step 7: ...Peeling complete. Best community has " << best.size() << " nodes." << std::endl;
 
-        // 8. 从幸存节点开始，提取最终的连通 k-truss 社区
-        std::cout << "[DEBUG] Step 8: Extracting final connected component from the k-truss candidates..." << std::endl;
-        unordered_set<int> final_k_truss_component = extract_connected_component(
-            surviving_query_node, 
-            k_truss_adj, 
-            k_truss_candidates
-        );
-        std::cout << "[DEBUG] Step 8: ...Extraction complete. Final component has " << final_k_truss_component.size() << " nodes." << std::endl;
-        
-        // 9. 封装并返回最终结果
-        return package_result(final_k_truss_component, node_probs);
+        // 8. 封装并返回最终结果
+        return package_result(to_global(space, best), space);
+    }
+
+    // ==========================================================
+    // 批量社区搜索
+    // ==========================================================
+    // 对所有查询节点只做一次剥离：搜索空间取所有受影响查询节点所在的受影响弱连通区域的并集。
+    // 各区域之间没有边，并集上的剥离结果就是各区域分别剥离结果的并，因此每个查询节点得到的社区
+    // 与单独查询它时相同；剥离后一次标记过程提取所有社区。
+
+    /**
+     * @brief [DIRECTED VERSION] 批量查找每个查询节点所在的弱连通 (k, l)-core 社区。
+     * @param dcore_index 可选的全图 D-core 索引，用于剥离前排除不在全图 (k, l)-core 中的节点。
+     */
+    static BatchCommunityResult find_kl_core_communities_batch(
+        int k_core,
+        int l_core,
+        const vector<NodeState>& final_states,
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        const DCoreIndex* dcore_index = nullptr
+    ) {
+        std::cout << "\n[DEBUG] --- Starting Batch Community Search (Directed (k,l)-core Mode) ---" << std::endl;
+        std::cout << "[DEBUG] k(in-degree)=" << k_core << ", l(out-degree)=" << l_core << ", Influenced Nodes=" << final_states.size() << ", Query Nodes=" << query_nodes.size() << std::endl;
+
+        SearchSpace space;
+        if (final_states.empty() || k_core < 0 || l_core < 0 || !collect_query_nodes(final_states, g, query_nodes, space)) {
+            return empty_batch(query_nodes);
+        }
+        if (dcore_index) {
+            build_search_space(g, space, [&](int v) { return dcore_index->in_kl_core(v, k_core, l_core); }, true);
+        } else {
+            build_search_space(g, space, [](int) { return true; }, true);
+        }
+        vector<char> alive = peel_kl_core(space.lg, k_core, l_core);
+        return label_communities(space, query_nodes, alive, nullptr);
+    }
+
+    /**
+     * @brief [UNDIRECTED VERSION] 批量查找每个查询节点所在的连通 k-core 社区。
+     * @param core_index 可选的全图核分解索引，用于剥离前排除全图核数 < k 的节点。
+     */
+    static BatchCommunityResult find_k_core_communities_batch(
+        int k_core,
+        const vector<NodeState>& final_states,
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        const CoreIndex* core_index = nullptr
+    ) {
+        std::cout << "\n[DEBUG] --- Starting Batch Community Search (Undirected k-core Mode) ---" << std::endl;
+        std::cout << "[DEBUG] k(undirected-degree)=" << k_core << ", Influenced Nodes=" << final_states.size() << ", Query Nodes=" << query_nodes.size() << std::endl;
+
+        SearchSpace space;
+        if (final_states.empty() || k_core < 0 || !collect_query_nodes(final_states, g, query_nodes, space)) {
+            return empty_batch(query_nodes);
+        }
+        if (core_index) {
+            build_search_space(g, space, [&](int v) { return core_index->core_number(v) >= k_core; }, true);
+        } else {
+            build_search_space(g, space, [](int) { return true; }, true);
+        }
+        vector<int> core = compute_core_numbers(space.lg.und_offset, space.lg.und_adj, g.num_threads);
+        vector<char> alive(space.lg.size(), 0);
+        for (int u = 0; u < space.lg.size(); ++u) {
+            alive[u] = core[u] >= k_core;
+        }
+        return label_communities(space, query_nodes, alive, nullptr);
+    }
+
+    /**
+     * @brief [UNDIRECTED VERSION] 批量查找每个查询节点所在的连通 k-truss 社区（只沿幸存的边连通）。
+     * @param truss_index 可选的全图 truss 分解索引，用于剥离前排除没有 trussness >= k 关联边的节点。
+     */
+    static BatchCommunityResult find_k_truss_communities_batch(
+        int k_truss,
+        const vector<NodeState>& final_states,
+        const InfGraph& g,
+        const vector<int>& query_nodes,
+        const TrussIndex* truss_index = nullptr
+    ) {
+        std::cout << "\n[DEBUG] --- Starting Batch Community Search (Undirected k-truss Mode) ---" << std::endl;
+        std::cout << "[DEBUG] k(trussness)=" << k_truss << ", Influenced Nodes=" << final_states.size() << ", Query Nodes=" << query_nodes.size() << std::endl;
+
+        SearchSpace space;
+        if (final_states.empty() || k_truss < 2 || !collect_query_nodes(final_states, g, query_nodes, space)) {
+            return empty_batch(query_nodes);
+        }
+        if (truss_index) {
+            build_search_space(g, space, [&](int v) { return truss_index->node_truss_number(v) >= k_truss; }, true);
+        } else {
+            build_search_space(g, space, [](int) { return true; }, true);
+        }
+        vector<char> edge_alive = compute_k_truss(space.lg, k_truss - 2, g.num_threads);
+        vector<char> node_alive(space.lg.size(), 0);
+        for (int e = 0; e < space.lg.num_edges(); ++e) {
+            if (!edge_alive[e]) continue;
+            node_alive[space.lg.edge_u[e]] = 1;
+            node_alive[space.lg.edge_v[e]] = 1;
+        }
+        return label_communities(space, query_nodes, node_alive, &edge_alive);
     }
 
 };
@@ -0,0 +1,195 @@
+#ifndef CORE_INDEX_H
+#define CORE_INDEX_H
+
+#include "parallel_peel.h"
+
+// 核分解索引：全图的核数（Batagelj–Zaversnik）与核森林（壳层次结构）。
+// 核森林的每个树节点对应某个 k 下 k-core 的一个连通分量，子节点是它在更大 k 下分裂出的分量；
+// 节点按森林的先序排列，使每个树节点的子树在 order 中是一段连续区间。
+// 因此"包含 v 的连通 k-core"只需从 v 所在的树节点向上走到最后一个层级 >= k 的祖先，
+// 再读出该祖先的区间，代价与输出规模成正比。每个数据集只需构建一次，构建后只读。
+class CoreIndex
+{
+private:
+    vector<int> core;        // 节点的核数
+    vector<int> node_tree;   // 节点首次出现（核数层级）所在的树节点
+    vector<int> tree_level;  // 树节点对应的 k
+    vector<int> tree_parent; // 父树节点，根为 -1
+    vector<int> tree_begin, tree_end; // 树节点子树在 order 中的区间
+    vector<int> order;       // 按核森林先序排列的节点
+    int max_core_ = 0;
+
+    static int find_root(vector<int> &uf, int x)
+    {
+        while (uf[x] != x)
+        {
+            uf[x] = uf[uf[x]];
+            x = uf[x];
+        }
+        return x;
+    }
+
+public:
+    // lg 为全图快照（局部ID与全局ID一致），使用其中的无向视图；大图上核数按层并行剥离
+    explicit CoreIndex(const LocalGraph &lg, int num_threads = default_num_threads())
+    {
+        const int n = lg.size();
+        core = compute_core_numbers(lg.und_offset, lg.und_adj, num_threads);
+        for (int v = 0; v < n; ++v)
+            max_core_ = std::max(max_core_, core[v]);
+
+        // 1. 按核数分桶
+        vector<int> shell_offset(max_core_ + 2, 0), by_core(n);
+        for (int v = 0; v < n; ++v)
+            shell_offset[core[v] + 1]++;
+        for (int k = 0; k <= max_core_; ++k)
+            shell_offset[k + 1] += shell_offset[k];
+        {
+            vector<int> cursor(shell_offset.begin(), shell_offset.end() - 1);
+            for (int v = 0; v < n; ++v)
+                by_core[cursor[core[v]]++] = v;
+        }
+
+        // 2. k 从大到小逐层加入核数为 k 的节点并用并查集合并：每层结束时每个集合就是 k-core 的一个连通分量。
+        //    本层有变化（加入了新节点或发生合并）的集合新建一个树节点，被合并的旧分量成为它的子节点。
+        vector<int> uf(n), comp_tree(n, -1), level_node(n, -1), created;
+        vector<std::pair<int, int>> attach; // (本层节点, 它所连接的更高层分量的树节点)
+        for (int v = 0; v < n; ++v)
+            uf[v] = v;
+        node_tree.assign(n, -1);
+        for (int k = max_core_; k >= 0; --k)
+        {
+            const int first = shell_offset[k], last = shell_offset[k + 1];
+            if (first == last)
+                continue;
+            attach.clear();
+            for (int i = first; i < last; ++i)
+            {
+                int v = by_core[i];
+                for (int e = lg.und_offset[v]; e < lg.und_offset[v + 1]; ++e)
+                {
+                    int u = lg.und_adj[e];
+                    if (core[u] > k)
+                        attach.push_back({v, comp_tree[find_root(uf, u)]});
+                }
+            }
+            for (int i = first; i < last; ++i)
+            {
+                int v = by_core[i];
+                for (int e = lg.und_offset[v]; e < lg.und_offset[v + 1]; ++e)
+                {
+                    int u = lg.und_adj[e];
+                    if (core[u] < k)
+                        continue;
+                    int ru = find_root(uf, u), rv = find_root(uf, v);
+                    if (ru != rv)
+                        uf[ru] = rv;
+                }
+            }
+
+            created.clear();
+            for (int i = first; i < last; ++i)
+            {
+                int v = by_core[i];
+                int r = find_root(uf, v);
+                if (level_node[r] == -1)
+                {
+                    level_node[r] = tree_level.size();
+                    tree_level.push_back(k);
+                    tree_parent.push_back(-1);
+                    created.push_back(r);
+                }
+                node_tree[v] = level_node[r];
+            }
+            for (const auto &a : attach)
+            {
+                int parent = level_node[find_root(uf, a.first)];
+                if (tree_parent[a.second] == -1 && a.second != parent)
+                    tree_parent[a.second] = parent;
+            }
+            for (int r : created)
+            {
+                comp_tree[r] = level_node[r];
+                level_node[r] = -1;
+            }
+        }
+
+        // 3. 先序遍历核森林，确定每个树节点子树的区间
+        const int num_tree = tree_level.size();
+        vector<int> child_offset(num_tree + 1, 0), children(num_tree);
+        vector<int> member_offset(num_tree + 1, 0), members(n);
+        for (int t = 0; t < num_tree; ++t)
+        {
+            if (tree_parent[t] != -1)
+                child_offset[tree_parent[t] + 1]++;
+        }
+        for (int v = 0; v < n; ++v)
+            member_offset[node_tree[v] + 1]++;
+        for (int t = 0; t < num_tree; ++t)
+        {
+            child_offset[t + 1] += child_offset[t];
+            member_offset[t + 1] += member_offset[t];
+        }
+        {
+            vector<int> cursor(child_offset.begin(), child_offset.end() - 1);
+            for (int t = 0; t < num_tree; ++t)
+            {
+                if (tree_parent[t] != -1)
+                    children[cursor[tree_parent[t]]++] = t;
+            }
+            vector<int> mcursor(member_offset.begin(), member_offset.end() - 1);
+            for (int v = 0; v < n; ++v)
+                members[mcursor[node_tree[v]]++] = v;
+        }
+
+        tree_begin.assign(num_tree, 0);
+        tree_end.assign(num_tree, 0);
+        order.reserve(n);
+        vector<std::pair<int, int>> stack; // (树节点, 下一个待访问的子节点位置)
+        for (int root = 0; root < num_tree; ++root)
+        {
+            if (tree_parent[root] != -1)
+                continue;
+            stack.push_back({root, child_offset[root]});
+            tree_begin[root] = order.size();
+            order.insert(order.end(), members.begin() + member_offset[root], members.begin() + member_offset[root + 1]);
+            while (!stack.empty())
+            {
+                int t = stack.back().first;
+                int &next = stack.back().second;
+                if (next == child_offset[t + 1])
+                {
+                    tree_end[t] = order.size();
+                    stack.pop_back();
+                    continue;
+                }
+                int c = children[next++];
+                tree_begin[c] = order.size();
+                order.insert(order.end(), members.begin() + member_offset[c], members.begin() + member_offset[c + 1]);
+                stack.push_back({c, child_offset[c]});
+            }
+        }
+    }
+
+    int size() const { return (int)core.size(); }
+    int max_core() const { return max_core_; }
+    int core_number(int v) const { return core[v]; }
+
+    size_t memory_bytes() const
+    {
+        return (core.size() + node_tree.size() + tree_level.size() + tree_parent.size() + tree_begin.size() + tree_end.size() + order.size()) * sizeof(int);
+    }
+
+    // 包含 v 的连通 k-core 的节点（v 的核数 < k 时为空），按核森林先序排列
+    vector<int> community(int v, int k) const
+    {
+        if (v < 0 || v >= size() || core[v] < k)
+            return {};
+        int t = node_tree[v];
+        while (tree_parent[t] != -1 && tree_level[tree_parent[t]] >= k)
+            t = tree_parent[t];
+        return vector<int>(order.begin() + tree_begin[t], order.begin() + tree_end[t]);
+    }
+};
+
+#endif // CORE_INDEX_H
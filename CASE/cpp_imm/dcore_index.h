@@ -0,0 +1,259 @@
+#ifndef DCORE_INDEX_H
+#define DCORE_INDEX_H
+
+#include "local_graph.h"
+#include <memory>
+
+// D-core（有向 (k,l)-core）分解索引。对每个 k 记录节点 v 仍属于 (k,l)-core 的最大 l，记为 l_k(v)
+// （v 不在 (k,0)-core 中时为 -1）。(k,l)-core 中入度、出度都按子图内的有向边计数（与 peel_kl_core 一致）。
+//   - 一次按入度的桶排序剥离得到每个节点的入度核数 in_core(v)，(k,0)-core 即 in_core >= k 的节点；
+//   - 节点和邻接表都按 in_core 降序排列一次：(k,0)-core 是节点序的前缀，层 k 只扫描邻接表中 in_core >= k 的前缀；
+//     (k,0)-core 内的入度/出度从 k 带到 k+1，只需删去 in_core == k 的节点并更新其邻居，整个过程 O(n + m)；
+//   - 每个 k 在自己的 (k,0)-core 内按出度剥离，代价为 O(|V_k| + |E_k|)，总代价与索引大小同阶；
+//   - l_k(v) 随 k 单调不增，按节点以 CSR 存放 l_0(v) .. l_{in_core(v)}(v)，总大小不超过 n + m。
+// 查询 (k,l) 时只需判断 l_k(v) >= l，滑动 k、l 不需要重新分解。构建后只读。
+class DCoreIndex
+{
+private:
+    std::shared_ptr<const LocalGraph> graph; // 全图快照（局部ID与全局ID一致）
+    vector<int> in_core;                     // 入度核数
+    vector<int> sky_offset;                  // 节点 v 的 l_k(v) 存放在 sky[sky_offset[v] + k]
+    vector<int> sky;
+    int max_k_ = 0;
+
+    // 按入度做 Batagelj–Zaversnik 剥离：删除 v 时其出邻居的入度减一（重边按条计数）
+    static vector<int> in_core_numbers(const LocalGraph &lg)
+    {
+        const int n = lg.size();
+        vector<int> deg(n), core(n);
+        int max_deg = 0;
+        for (int v = 0; v < n; ++v)
+        {
+            deg[v] = lg.in_offset[v + 1] - lg.in_offset[v];
+            max_deg = std::max(max_deg, deg[v]);
+        }
+        vector<int> bin(max_deg + 1, 0), pos(n), vert(n);
+        for (int v = 0; v < n; ++v)
+            bin[deg[v]]++;
+        for (int d = 0, start = 0; d <= max_deg; ++d)
+        {
+            int cnt = bin[d];
+            bin[d] = start;
+            start += cnt;
+        }
+        for (int v = 0; v < n; ++v)
+        {
+            pos[v] = bin[deg[v]]++;
+            vert[pos[v]] = v;
+        }
+        for (int d = max_deg; d > 0; --d)
+            bin[d] = bin[d - 1];
+        bin[0] = 0;
+
+        for (int i = 0; i < n; ++i)
+        {
+            int v = vert[i];
+            core[v] = deg[v];
+            for (int k = lg.out_offset[v]; k < lg.out_offset[v + 1]; ++k)
+            {
+                int u = lg.out_adj[k];
+                if (deg[u] > deg[v])
+                {
+                    int du = deg[u], pu = pos[u];
+                    int pw = bin[du], w = vert[pw];
+                    if (u != w)
+                    {
+                        pos[u] = pw;
+                        vert[pu] = w;
+                        pos[w] = pu;
+                        vert[pw] = u;
+                    }
+                    bin[du]++;
+                    deg[u]--;
+                }
+            }
+        }
+        return core;
+    }
+
+public:
+    explicit DCoreIndex(std::shared_ptr<const LocalGraph> snapshot) : graph(std::move(snapshot))
+    {
+        const LocalGraph &lg = *graph;
+        const int n = lg.size();
+        in_core = in_core_numbers(lg);
+        sky_offset.assign(n + 1, 0);
+        for (int v = 0; v < n; ++v)
+        {
+            max_k_ = std::max(max_k_, in_core[v]);
+            sky_offset[v + 1] = sky_offset[v] + in_core[v] + 1;
+        }
+        sky.assign(sky_offset[n], -1);
+
+        // 节点按 in_core 降序排列，core_end[k] 为 (k,0)-core 的节点数
+        vector<int> core_end(max_k_ + 2, 0), order(n);
+        for (int v = 0; v < n; ++v)
+            core_end[in_core[v]]++;
+        for (int k = max_k_ - 1; k >= 0; --k)
+            core_end[k] += core_end[k + 1];
+        {
+            vector<int> cursor(max_k_ + 1);
+            for (int k = 0; k <= max_k_; ++k)
+                cursor[k] = core_end[k + 1];
+            for (int v = 0; v < n; ++v)
+                order[cursor[in_core[v]]++] = v;
+        }
+
+        // 邻接表按邻居的 in_core 降序重排：按上面的节点序依次把节点追加到其邻居的表中即可
+        vector<int> in_by_core(lg.in_adj.size()), out_by_core(lg.out_adj.size());
+        {
+            vector<int> in_fill(lg.in_offset.begin(), lg.in_offset.end() - 1);
+            vector<int> out_fill(lg.out_offset.begin(), lg.out_offset.end() - 1);
+            for (int w : order)
+            {
+                for (int e = lg.out_offset[w]; e < lg.out_offset[w + 1]; ++e)
+                    in_by_core[in_fill[lg.out_adj[e]]++] = w;
+                for (int e = lg.in_offset[w]; e < lg.in_offset[w + 1]; ++e)
+                    out_by_core[out_fill[lg.in_adj[e]]++] = w;
+            }
+        }
+
+        // core_in / core_out：(k,0)-core 内的入度、出度，随 k 增大增量维护
+        vector<int> core_in(n), core_out(n);
+        for (int v = 0; v < n; ++v)
+        {
+            core_in[v] = lg.in_offset[v + 1] - lg.in_offset[v];
+            core_out[v] = lg.out_offset[v + 1] - lg.out_offset[v];
+        }
+
+        // 对每个 k，在 (k,0)-core 内按出度从小到大剥离；出度降到当前层以下或入度降到 k 以下的节点立即删除
+        vector<int> in_deg(n), out_deg(n), worklist;
+        vector<char> alive(n, 0), queued(n, 0);
+        vector<vector<int>> buckets;
+        for (int k = 0; k <= max_k_; ++k)
+        {
+            const int members = core_end[k];
+            int max_out = 0;
+            for (int i = 0; i < members; ++i)
+            {
+                int v = order[i];
+                alive[v] = 1;
+                queued[v] = 0;
+                in_deg[v] = core_in[v];
+                out_deg[v] = core_out[v];
+                max_out = std::max(max_out, out_deg[v]);
+            }
+            if (buckets.size() < (size_t)max_out + 1)
+                buckets.resize(max_out + 1);
+            for (int i = 0; i < members; ++i)
+                buckets[out_deg[order[i]]].push_back(order[i]);
+
+            for (int level = 0; level <= max_out; ++level)
+            {
+                while (!worklist.empty() || !buckets[level].empty())
+                {
+                    int v;
+                    if (!worklist.empty())
+                    {
+                        v = worklist.back();
+                        worklist.pop_back();
+                    }
+                    else
+                    {
+                        v = buckets[level].back();
+                        buckets[level].pop_back();
+                        if (queued[v] || !alive[v] || out_deg[v] != level)
+                            continue; // 过期的桶条目
+                    }
+                    if (!alive[v])
+                        continue;
+                    alive[v] = 0;
+                    sky[sky_offset[v] + k] = level;
+
+                    // v 的入邻居失去一条出边，出邻居失去一条入边（只扫描 (k,0)-core 内的邻居）
+                    for (int e = lg.in_offset[v]; e < lg.in_offset[v + 1] && in_core[in_by_core[e]] >= k; ++e)
+                    {
+                        int u = in_by_core[e];
+                        if (!alive[u] || queued[u])
+                            continue;
+                        if (--out_deg[u] <= level)
+                        {
+                            queued[u] = 1;
+                            worklist.push_back(u);
+                        }
+                        else
+                            buckets[out_deg[u]].push_back(u);
+                    }
+                    for (int e = lg.out_offset[v]; e < lg.out_offset[v + 1] && in_core[out_by_core[e]] >= k; ++e)
+                    {
+                        int u = out_by_core[e];
+                        if (!alive[u] || queued[u])
+                            continue;
+                        if (--in_deg[u] < k)
+                        {
+                            queued[u] = 1;
+                            worklist.push_back(u);
+                        }
+                    }
+                }
+            }
+            for (int level = 0; level <= max_out; ++level)
+                buckets[level].clear();
+
+            // 转到 (k+1,0)-core：删去 in_core == k 的节点，其在 (k+1,0)-core 内的邻居度数减一
+            for (int i = core_end[k + 1]; i < members; ++i)
+            {
+                int v = order[i];
+                for (int e = lg.in_offset[v]; e < lg.in_offset[v + 1] && in_core[in_by_core[e]] > k; ++e)
+                    core_out[in_by_core[e]]--;
+                for (int e = lg.out_offset[v]; e < lg.out_offset[v + 1] && in_core[out_by_core[e]] > k; ++e)
+                    core_in[out_by_core[e]]--;
+            }
+        }
+    }
+
+    int size() const { return (int)in_core.size(); }
+    int max_k() const { return max_k_; }
+
+    size_t memory_bytes() const
+    {
+        return (in_core.size() + sky_offset.size() + sky.size()) * sizeof(int);
+    }
+
+    // v 仍属于 (k,l)-core 的最大 l；v 不在 (k,0)-core 中时为 -1
+    int max_l(int v, int k) const
+    {
+        if (v < 0 || v >= size() || k < 0 || k > in_core[v])
+            return -1;
+        return sky[sky_offset[v] + k];
+    }
+
+    bool in_kl_core(int v, int k, int l) const { return l >= 0 && max_l(v, k) >= l; }
+
+    // 包含 v 的弱连通 (k,l)-core 的节点（v 不在 (k,l)-core 中时为空），按遍历顺序排列
+    vector<int> community(int v, int k, int l) const
+    {
+        if (!in_kl_core(v, k, l))
+            return {};
+        const LocalGraph &lg = *graph;
+        vector<int> comp(1, v);
+        vector<char> seen(lg.size(), 0);
+        seen[v] = 1;
+        for (size_t head = 0; head < comp.size(); ++head)
+        {
+            int u = comp[head];
+            for (int e = lg.und_offset[u]; e < lg.und_offset[u + 1]; ++e)
+            {
+                int w = lg.und_adj[e];
+                if (!seen[w] && in_kl_core(w, k, l))
+                {
+                    seen[w] = 1;
+                    comp.push_back(w);
+                }
+            }
+        }
+        return comp;
+    }
+};
+
+#endif // DCORE_INDEX_H
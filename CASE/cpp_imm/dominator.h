@@ -0,0 +1,382 @@
+#ifndef DOMINATOR_H
+#define DOMINATOR_H
+
+#include "live_edge.h"
+
+// Lengauer–Tarjan 支配树（带路径压缩的简单版本，O(m log n)）。
+// 虚拟根 0 指向所有种子，局部节点 i 对应顶点 i + 1，内部数组均按DFS序编号。
+class DominatorTree
+{
+private:
+    vector<int> dfn, vertex, parent, semi, idom, label, ancestor;
+    vector<int> pred_offset, pred, pred_eid, cursor;
+    vector<int> bucket_head, bucket_next, subtree, dom_pos, dom_fill;
+    vector<pair<int, int>> dfs_stack;
+    vector<int> compress_stack;
+
+    int eval(int v)
+    {
+        if (ancestor[v] < 0)
+            return v;
+        int x = v;
+        while (ancestor[ancestor[x]] >= 0)
+        {
+            compress_stack.push_back(x);
+            x = ancestor[x];
+        }
+        while (!compress_stack.empty())
+        {
+            int y = compress_stack.back();
+            compress_stack.pop_back();
+            int a = ancestor[y];
+            if (semi[label[a]] < semi[label[y]])
+                label[y] = label[a];
+            ancestor[y] = ancestor[a];
+        }
+        return label[v];
+    }
+
+    // 顶点 v 的第 i 个后继及其边ID（虚拟根的后继是所有种子，边ID为 -1）
+    static int successor_count(const LiveEdgeSample &s, int v)
+    {
+        return v == 0 ? s.num_roots : s.offset[v] - s.offset[v - 1];
+    }
+    static int successor(const LiveEdgeSample &s, int v, int i)
+    {
+        return v == 0 ? i + 1 : s.adj[s.offset[v - 1] + i] + 1;
+    }
+    static int successor_eid(const LiveEdgeSample &s, int v, int i)
+    {
+        return v == 0 ? -1 : s.adj_eid[s.offset[v - 1] + i];
+    }
+    static bool edge_removed(const vector<char> &removed_edges, int eid)
+    {
+        return eid >= 0 && !removed_edges.empty() && removed_edges[eid];
+    }
+
+public:
+    // 计算删除 removed 中节点、removed_edges 中边后的支配树。
+    // dominated[i] 为局部节点 i 支配的节点数（含自身），不可达节点为 0；
+    // 若提供 cut_edge，则 cut_edge[i] 为节点 i 的“割入边”ID（否则为 -1）：i 的可达入边中只有这一条
+    // 来自不被 i 支配的前驱（其余前驱都只能经过 i 到达，即位于经过 i 的环上），删除它恰好挽救
+    // dominated[i] 个节点；不存在这样的边时，删除 i 的任一入边都挽救不了任何节点。
+    // removed / removed_edges 以全局ID为下标。
+    void compute(
+        const LiveEdgeSample &s,
+        const vector<char> &removed,
+        vector<int> &dominated,
+        const vector<char> &removed_edges = {},
+        vector<int> *cut_edge = nullptr)
+    {
+        const int N = (int)s.nodes.size() + 1;
+        dfn.assign(N, -1);
+        vertex.clear();
+        parent.clear();
+
+        // 1. 迭代式DFS编号
+        dfn[0] = 0;
+        vertex.push_back(0);
+        parent.push_back(-1);
+        dfs_stack.clear();
+        dfs_stack.push_back({0, 0});
+        while (!dfs_stack.empty())
+        {
+            int v = dfs_stack.back().first;
+            int &next = dfs_stack.back().second;
+            if (next >= successor_count(s, v))
+            {
+                dfs_stack.pop_back();
+                continue;
+            }
+            int i = next++;
+            int w = successor(s, v, i);
+            if (dfn[w] >= 0 || removed[s.nodes[w - 1]] || edge_removed(removed_edges, successor_eid(s, v, i)))
+                continue;
+            dfn[w] = vertex.size();
+            vertex.push_back(w);
+            parent.push_back(dfn[v]);
+            dfs_stack.push_back({w, 0});
+        }
+        const int cnt = vertex.size();
+
+        // 2. 构建DFS序下的前驱表
+        pred_offset.assign(cnt + 1, 0);
+        for (int i = 0; i < cnt; ++i)
+        {
+            int v = vertex[i];
+            for (int j = 0, d = successor_count(s, v); j < d; ++j)
+            {
+                int w = successor(s, v, j);
+                if (dfn[w] >= 0 && !edge_removed(removed_edges, successor_eid(s, v, j)))
+                    pred_offset[dfn[w] + 1]++;
+            }
+        }
+        for (int i = 0; i < cnt; ++i)
+            pred_offset[i + 1] += pred_offset[i];
+        pred.resize(pred_offset[cnt]);
+        pred_eid.resize(pred_offset[cnt]);
+        cursor.assign(pred_offset.begin(), pred_offset.end() - 1);
+        for (int i = 0; i < cnt; ++i)
+        {
+            int v = vertex[i];
+            for (int j = 0, d = successor_count(s, v); j < d; ++j)
+            {
+                int w = successor(s, v, j);
+                int eid = successor_eid(s, v, j);
+                if (dfn[w] >= 0 && !edge_removed(removed_edges, eid))
+                {
+                    pred_eid[cursor[dfn[w]]] = eid;
+                    pred[cursor[dfn[w]]++] = i;
+                }
+            }
+        }
+
+        // 3. 计算半支配点与直接支配点
+        semi.resize(cnt);
+        idom.assign(cnt, 0);
+        label.resize(cnt);
+        ancestor.assign(cnt, -1);
+        bucket_head.assign(cnt, -1);
+        bucket_next.assign(cnt, -1);
+        for (int i = 0; i < cnt; ++i)
+            semi[i] = label[i] = i;
+
+        for (int w = cnt - 1; w >= 1; --w)
+        {
+            for (int k = pred_offset[w]; k < pred_offset[w + 1]; ++k)
+            {
+                int u = eval(pred[k]);
+                if (semi[u] < semi[w])
+                    semi[w] = semi[u];
+            }
+            bucket_next[w] = bucket_head[semi[w]];
+            bucket_head[semi[w]] = w;
+
+            int p = parent[w];
+            ancestor[w] = p;
+            for (int v = bucket_head[p]; v != -1; v = bucket_next[v])
+            {
+                int u = eval(v);
+                idom[v] = (semi[u] < semi[v]) ? u : p;
+            }
+            bucket_head[p] = -1;
+        }
+        for (int w = 1; w < cnt; ++w)
+        {
+            if (idom[w] != semi[w])
+                idom[w] = idom[idom[w]];
+        }
+
+        // 4. 支配子树大小：直接支配点的DFS序总是更小，逆序累加即可
+        subtree.assign(cnt, 1);
+        for (int w = cnt - 1; w >= 1; --w)
+            subtree[idom[w]] += subtree[w];
+
+        dominated.assign(s.nodes.size(), 0);
+        for (int w = 1; w < cnt; ++w)
+            dominated[vertex[w] - 1] = subtree[w];
+
+        if (cut_edge != nullptr)
+        {
+            // 支配树的先序位置：x 支配 y 当且仅当 dom_pos[x] <= dom_pos[y] < dom_pos[x] + subtree[x]。
+            // 直接支配点的DFS序更小，按DFS序依次为每个子树在父区间内分配一段连续位置即可。
+            dom_pos.assign(cnt, 0);
+            dom_fill.assign(cnt, 1);
+            for (int w = 1; w < cnt; ++w)
+            {
+                dom_pos[w] = dom_pos[idom[w]] + dom_fill[idom[w]];
+                dom_fill[idom[w]] += subtree[w];
+            }
+            cut_edge->assign(s.nodes.size(), -1);
+            for (int w = 1; w < cnt; ++w)
+            {
+                int entries = 0, entry_eid = -1;
+                for (int k = pred_offset[w]; k < pred_offset[w + 1] && entries < 2; ++k)
+                {
+                    int p = pred[k];
+                    if (dom_pos[p] >= dom_pos[w] && dom_pos[p] < dom_pos[w] + subtree[w])
+                        continue; // 前驱被 w 支配
+                    entries++;
+                    entry_eid = pred_eid[k];
+                }
+                if (entries == 1)
+                    (*cut_edge)[vertex[w] - 1] = entry_eid;
+            }
+        }
+    }
+};
+
+// 基于支配树的阻塞节点选择：对每个活跃边样本，阻塞节点 u 可挽救的节点数
+// 恰为 u 在支配树中的子树大小。贪心地选择期望挽救数最大的节点，
+// 每轮只重算包含新阻塞节点的样本。
+class DominatorBlocker
+{
+public:
+    // 选择 budget 个阻塞节点，结果写入 g.result_node_set。
+    // 返回每个阻塞节点被选中时的期望挽救节点数（边际收益）。
+    static vector<double> select(InfGraph &g, const vector<int> &negative_seeds, int budget, int num_samples)
+    {
+        assert(g.active_probT != nullptr && g.active_probFwd != nullptr && "Probability model must be set.");
+        g.result_node_set.clear();
+        vector<double> gains;
+        if (negative_seeds.empty() || budget <= 0 || num_samples <= 0)
+            return gains;
+
+        const int n = g.n;
+        vector<LiveEdgeSample> samples = LiveEdgeSampler::sample_from_seeds(g, negative_seeds, num_samples);
+        vector<vector<int>> dominated(num_samples);
+        vector<char> is_blocked(n, 0);
+
+        // 1. 并行计算每个样本的初始支配树
+        parallel_for(num_samples, g.num_threads, [&](int, int64_t begin, int64_t end)
+        {
+            DominatorTree tree;
+            for (int64_t i = begin; i < end; ++i)
+                tree.compute(samples[i], is_blocked, dominated[i]);
+        });
+
+        // 2. 建立 节点 -> 样本 的倒排索引，并累加初始得分
+        vector<char> is_seed(n, 0);
+        for (int seed : negative_seeds)
+        {
+            if (seed >= 0 && seed < n)
+                is_seed[seed] = 1;
+        }
+        vector<vector<int>> node_samples(n);
+        vector<int64_t> score(n, 0);
+        for (int i = 0; i < num_samples; ++i)
+        {
+            const LiveEdgeSample &s = samples[i];
+            for (size_t j = s.num_roots; j < s.nodes.size(); ++j)
+            {
+                node_samples[s.nodes[j]].push_back(i);
+                score[s.nodes[j]] += dominated[i][j];
+            }
+        }
+
+        // 3. 贪心选择，每轮只重算受影响的样本
+        vector<vector<int>> updated;
+        for (int round = 0; round < budget; ++round)
+        {
+            int best = -1;
+            for (int v = 0; v < n; ++v)
+            {
+                if (is_seed[v] || is_blocked[v] || score[v] <= 0)
+                    continue;
+                if (best == -1 || score[v] > score[best])
+                    best = v;
+            }
+            if (best == -1)
+                break;
+
+            g.result_node_set.push_back(best);
+            gains.push_back(static_cast<double>(score[best]) / num_samples);
+            is_blocked[best] = 1;
+
+            const vector<int> &affected = node_samples[best];
+            updated.assign(affected.size(), vector<int>());
+            parallel_for(affected.size(), g.num_threads, [&](int, int64_t begin, int64_t end)
+            {
+                DominatorTree tree;
+                for (int64_t i = begin; i < end; ++i)
+                    tree.compute(samples[affected[i]], is_blocked, updated[i]);
+            });
+
+            for (size_t i = 0; i < affected.size(); ++i)
+            {
+                int idx = affected[i];
+                const LiveEdgeSample &s = samples[idx];
+                for (size_t j = s.num_roots; j < s.nodes.size(); ++j)
+                    score[s.nodes[j]] += updated[i][j] - dominated[idx][j];
+                dominated[idx].swap(updated[i]);
+            }
+        }
+        return gains;
+    }
+
+    // 边阻塞模式：选择 budget 条要删除的边（返回边ID）。在每个样本中，
+    // 删除边 (u, v) 能挽救的节点数为：若它是 v 的割入边（v 的其余可达前驱都被 v 支配），则为 v 的支配子树大小，否则为 0。
+    // gains 中返回每条边被选中时的期望挽救节点数。
+    static vector<int> select_edges(InfGraph &g, const vector<int> &negative_seeds, int budget, int num_samples, vector<double> &gains)
+    {
+        assert(g.active_probT != nullptr && g.active_probFwd != nullptr && "Probability model must be set.");
+        vector<int> chosen_edges;
+        gains.clear();
+        if (negative_seeds.empty() || budget <= 0 || num_samples <= 0)
+            return chosen_edges;
+
+        vector<LiveEdgeSample> samples = LiveEdgeSampler::sample_from_seeds(g, negative_seeds, num_samples);
+        vector<vector<int>> dominated(num_samples), cut_in(num_samples);
+        const vector<char> no_removed_nodes(g.n, 0);
+        vector<char> is_edge_blocked(g.m, 0);
+
+        // 1. 并行计算每个样本的初始支配树
+        parallel_for(num_samples, g.num_threads, [&](int, int64_t begin, int64_t end)
+        {
+            DominatorTree tree;
+            for (int64_t i = begin; i < end; ++i)
+                tree.compute(samples[i], no_removed_nodes, dominated[i], is_edge_blocked, &cut_in[i]);
+        });
+
+        // 2. 建立 边 -> 样本 的倒排索引，并累加初始得分
+        vector<vector<int>> edge_samples(g.m);
+        vector<int64_t> score(g.m, 0);
+        for (int i = 0; i < num_samples; ++i)
+        {
+            for (int eid : samples[i].adj_eid)
+                edge_samples[eid].push_back(i);
+            for (size_t j = 0; j < cut_in[i].size(); ++j)
+            {
+                if (cut_in[i][j] >= 0)
+                    score[cut_in[i][j]] += dominated[i][j];
+            }
+        }
+
+        // 3. 贪心选择，每轮只重算包含新删除边的样本
+        vector<vector<int>> updated_dom, updated_cut;
+        for (int round = 0; round < budget; ++round)
+        {
+            int best = -1;
+            for (int e = 0; e < g.m; ++e)
+            {
+                if (is_edge_blocked[e] || score[e] <= 0)
+                    continue;
+                if (best == -1 || score[e] > score[best])
+                    best = e;
+            }
+            if (best == -1)
+                break;
+
+            chosen_edges.push_back(best);
+            gains.push_back(static_cast<double>(score[best]) / num_samples);
+            is_edge_blocked[best] = 1;
+
+            const vector<int> &affected = edge_samples[best];
+            updated_dom.assign(affected.size(), vector<int>());
+            updated_cut.assign(affected.size(), vector<int>());
+            parallel_for(affected.size(), g.num_threads, [&](int, int64_t begin, int64_t end)
+            {
+                DominatorTree tree;
+                for (int64_t i = begin; i < end; ++i)
+                    tree.compute(samples[affected[i]], no_removed_nodes, updated_dom[i], is_edge_blocked, &updated_cut[i]);
+            });
+
+            for (size_t i = 0; i < affected.size(); ++i)
+            {
+                int idx = affected[i];
+                for (size_t j = 0; j < cut_in[idx].size(); ++j)
+                {
+                    if (cut_in[idx][j] >= 0)
+                        score[cut_in[idx][j]] -= dominated[idx][j];
+                    if (updated_cut[i][j] >= 0)
+                        score[updated_cut[i][j]] += updated_dom[i][j];
+                }
+                dominated[idx].swap(updated_dom[i]);
+                cut_in[idx].swap(updated_cut[i]);
+            }
+        }
+        return chosen_edges;
+    }
+};
+
+#endif // DOMINATOR_H
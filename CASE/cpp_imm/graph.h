@@ -28,6 +28,10 @@ public:
     vector<vector<double>> prob_tr;
     vector<vector<double>> prob_co;
 
+    // Edge IDs: forward edge g[u][j] has ID out_offset[u] + j; in_eid[v][i] is the ID of gT[v][i]
+    vector<int> out_offset;
+    vector<vector<int>> in_eid;
+
     Graph(const string& graph_filepath)
     {
         loadGraphFromEdgeList(graph_filepath);
@@ -73,13 +77,25 @@ private:
         prob_co.resize(n); prob_fwd_co.resize(n);
 
         // Build both graphs
+        in_eid.resize(n);
         for (const auto& edge : edges) {
             u = edge.first;
             v = edge.second;
+            in_eid[v].push_back(g[u].size()); // position in g[u], converted to an ID below
             g[u].push_back(v);   // Forward edge u -> v
             gT[v].push_back(u);  // Transposed edge v <- u
             inDeg[v]++;
         }
+
+        out_offset.assign(n + 1, 0);
+        for (int i = 0; i < n; ++i) {
+            out_offset[i + 1] = out_offset[i] + g[i].size();
+        }
+        for (int i = 0; i < n; ++i) {
+            for (size_t j = 0; j < gT[i].size(); ++j) {
+                in_eid[i][j] += out_offset[gT[i][j]];
+            }
+        }
     }
 
     void precompute_all_probabilities() {
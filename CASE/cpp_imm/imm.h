@@ -23,6 +23,13 @@ public:
     }
 };
 
+// 自适应影响力最小化的采样统计
+struct MinimizationStats {
+    int64_t R = 0;                   // 最终使用的RR集数量
+    double reduction_estimate = 0.0; // 估计的影响力下降（节点数）
+    double confidence = 0.0;         // 估计值落在相对误差内的置信度（正态近似）
+};
+
 // IMM 算法核心实现
 class Imm {
 private:
@@ -59,6 +66,14 @@ private:
         g.build_max_coverage_set(arg.k);
     }
 
+    // 覆盖数为 covered 的比例估计，其相对误差不超过 relative_error 的置信度
+    static double coverage_confidence(int64_t covered, int64_t R, double relative_error) {
+        if (covered <= 0) return 0.0;
+        if (covered >= R) return 1.0;
+        double z = relative_error * sqrt((double)covered * R / (double)(R - covered));
+        return erf(z / sqrt(2.0));
+    }
+
 public:
     static void InfluenceMaximize(InfGraph& g, const Argument& arg) {
         g.init_hyper_graph();
@@ -66,6 +81,37 @@ public:
         g.init_hyper_graph();
         step2(g, arg, OPT_prime);
     }
+
+    // 自适应影响力最小化：以几何级数扩充带提前终止的RR集样本池，
+    // 直到阻塞后的影响力下降估计在相邻两轮间稳定、且置信度达到要求。
+    // 阻塞节点保存在 g.result_node_set 中。
+    static MinimizationStats InfluenceMinimize(InfGraph& g, const vector<int>& negative_seeds, int budget, double relative_error) {
+        const int64_t R_INIT = 1 << 10;
+        const int64_t R_MAX = 1 << 22;
+        const double TARGET_CONFIDENCE = 0.95;
+
+        MinimizationStats stats;
+        g.init_hyper_graph();
+        double prev_estimate = -1.0;
+        for (int64_t R = R_INIT; ; R *= 2) {
+            g.build_hyper_graph_for_minimization(R - (int64_t)g.hyperGT.size(), negative_seeds);
+            int64_t covered = g.build_blocking_set(budget, negative_seeds);
+
+            stats.R = R;
+            stats.reduction_estimate = (double)covered / R * g.n;
+            stats.confidence = coverage_confidence(covered, R, relative_error);
+
+            // 没有任何RR集被覆盖，说明阻塞无从发挥作用，继续采样也不会改变结论
+            if (covered == 0 && R >= 4 * R_INIT) break;
+            if (R >= R_MAX) break;
+
+            bool stable = prev_estimate > 0 &&
+                          fabs(stats.reduction_estimate - prev_estimate) <= relative_error * prev_estimate;
+            if (stable && stats.confidence >= TARGET_CONFIDENCE) break;
+            prev_estimate = stats.reduction_estimate;
+        }
+        return stats;
+    }
 };
 
 #endif // IMM_H
@@ -7,6 +7,8 @@
 
 #include "sfmt/SFMT.h"
 #include "api_structures.h" // 引入所有API数据结构
+#include "parallel.h"
+#include "wave_kernels.h"
 
 // 算法参数结构体
 struct Argument
@@ -25,6 +27,89 @@ enum InfluModel
     WC
 };
 
+// 64 位字中置位的个数
+inline int popcount64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int c = 0;
+    for (; x; x &= x - 1)
+        ++c;
+    return c;
+#endif
+}
+
+// 64 位字最低置位的下标（x 不能为 0）
+inline int ctz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int c = 0;
+    for (; !(x & 1); x >>= 1)
+        ++c;
+    return c;
+#endif
+}
+
+// 由两次 32 位抽样拼成一个 64 位随机字（只用 uint32 接口，避免与 uint64 接口混用）
+inline uint64_t sfmt_random_word64(sfmt_t *rng)
+{
+    uint64_t hi = sfmt_genrand_uint32(rng);
+    return (hi << 32) | sfmt_genrand_uint32(rng);
+}
+
+// 对 need 中的每个置位通道独立抽取概率为 prob 的伯努利变量，返回成功通道的掩码。
+// 通道较少时逐通道抽样；否则按位比较 32 位均匀数与 prob 的二进制展开（从高位到低位），
+// 每个随机字同时决定所有未定通道的一位，未定通道约每步减半。
+inline uint64_t bernoulli_mask64(double prob, uint64_t need, sfmt_t *rng)
+{
+    if (prob <= 0.0 || need == 0)
+        return 0;
+    if (prob >= 1.0)
+        return need;
+
+    double scaled = prob * 4294967296.0;
+    uint32_t threshold = scaled >= 4294967295.0 ? 0xFFFFFFFFu : (uint32_t)scaled;
+
+    uint64_t result = 0;
+    if (popcount64(need) <= 8)
+    {
+        for (uint64_t rest = need; rest; rest &= rest - 1)
+        {
+            if (sfmt_genrand_uint32(rng) < threshold)
+                result |= rest & (~rest + 1);
+        }
+        return result;
+    }
+
+    uint64_t undecided = need;
+    for (int bit = 31; bit >= 0 && undecided; --bit)
+    {
+        uint64_t r = sfmt_random_word64(rng);
+        if ((threshold >> bit) & 1u)
+        {
+            result |= undecided & ~r; // 该位随机数为 0 而阈值为 1：U < prob
+            undecided &= r;
+        }
+        else
+        {
+            undecided &= ~r; // 该位随机数为 1 而阈值为 0：U > prob
+        }
+    }
+    return result;
+}
+
+// 自适应蒙特卡洛估计的结果
+struct AdaptiveEstimate
+{
+    vector<double> probabilities; // 各节点的激活概率
+    int simulations = 0;          // 实际执行的模拟次数
+    double spread = 0.0;          // 平均激活节点数
+    double half_width = 0.0;      // spread 置信区间的半宽
+};
+
 class InfGraph : public Graph
 {
 private:
@@ -113,6 +198,204 @@ private:
         }
     }
 
+    // 位并行 IC 模拟：lanes 中的每一位对应一个独立的可能世界，active[v] 记录 v 在哪些世界中
+    // 被激活，pending[v] 记录尚未向外传播的新激活世界。节点每次出队时只为新激活、且邻居尚未
+    // 激活的世界抽取边的掩码，因此每条边在每个世界中至多抽样一次，与逐次模拟同分布。
+    // 结束后把各节点的激活世界数累加到 counts、各世界的激活节点数累加到 lane_spread，
+    // 并把用到的 active 项清零以便复用。
+    void simulate_ic_worlds64(
+        const vector<int> &initial_nodes,
+        const vector<bool> &is_blocked,
+        const vector<char> &blocked_edges,
+        uint64_t lanes,
+        sfmt_t *rng,
+        vector<uint64_t> &active,
+        vector<uint64_t> &pending,
+        vector<int> &frontier,
+        vector<int> &touched,
+        vector<int> &counts,
+        int64_t *lane_spread) const
+    {
+        frontier.clear();
+        touched.clear();
+        for (int seed : initial_nodes)
+        {
+            if (seed >= 0 && seed < n && !is_blocked[seed] && !active[seed])
+            {
+                active[seed] = lanes;
+                pending[seed] = lanes;
+                frontier.push_back(seed);
+                touched.push_back(seed);
+            }
+        }
+
+        for (size_t head = 0; head < frontier.size(); ++head)
+        {
+            int u = frontier[head];
+            uint64_t fresh = pending[u];
+            pending[u] = 0;
+
+            for (size_t j = 0; j < g[u].size(); ++j)
+            {
+                int v = g[u][j];
+                if (is_blocked[v] || is_edge_blocked(blocked_edges, u, j))
+                    continue;
+                uint64_t need = fresh & ~active[v];
+                if (!need)
+                    continue;
+
+                uint64_t hit = bernoulli_mask64((*active_probFwd)[u][j], need, rng);
+                if (!hit)
+                    continue;
+                if (!active[v])
+                    touched.push_back(v);
+                active[v] |= hit;
+                if (!pending[v])
+                    frontier.push_back(v);
+                pending[v] |= hit;
+            }
+        }
+
+        for (int v : touched)
+        {
+            counts[v] += popcount64(active[v]);
+            for (uint64_t rest = active[v]; rest; rest &= rest - 1)
+                lane_spread[ctz64(rest)]++;
+            active[v] = 0;
+        }
+    }
+
+    // 执行 num_simulations 次独立模拟，把各节点被激活的次数累加到 counts，
+    // 并把每次模拟激活节点数的和与平方和累加到 spread_sum / spread_sq_sum。
+    // 模拟在 num_threads 个线程间按段切分，每个线程使用由 next_seed() 派生的独立随机数流和
+    // 私有计数器，最后按线程归约，因此结果对给定的随机种子和线程数是确定的。
+    // IC/WC 模型以 64 个世界为一批做位并行模拟（见 simulate_ic_worlds64），LT 模型逐次模拟。
+    void accumulate_simulations(
+        const vector<int> &initial_nodes,
+        int64_t num_simulations,
+        const vector<bool> &is_blocked,
+        const vector<char> &blocked_edges,
+        vector<int64_t> &counts,
+        double &spread_sum,
+        double &spread_sq_sum)
+    {
+        const bool bit_parallel = (influModel != LT);
+        const int64_t work_items = bit_parallel ? (num_simulations + 63) / 64 : num_simulations;
+        const uint32_t base_seed = next_seed();
+        vector<vector<int>> thread_counts(num_threads);
+        vector<double> thread_sum(num_threads, 0.0), thread_sq_sum(num_threads, 0.0);
+        parallel_for(work_items, num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            sfmt_t rng;
+            sfmt_init_gen_rand(&rng, base_seed + t);
+            vector<int> &counts = thread_counts[t];
+            counts.assign(n, 0);
+
+            if (bit_parallel)
+            {
+                vector<uint64_t> active(n, 0), pending(n, 0);
+                vector<int> frontier, touched;
+                int64_t lane_spread[64];
+                for (int64_t b = begin; b < end; ++b)
+                {
+                    int64_t worlds = min<int64_t>(64, num_simulations - b * 64);
+                    uint64_t lanes = worlds == 64 ? ~0ULL : ((1ULL << worlds) - 1);
+                    std::fill(lane_spread, lane_spread + 64, 0);
+                    simulate_ic_worlds64(initial_nodes, is_blocked, blocked_edges, lanes, &rng,
+                                         active, pending, frontier, touched, counts, lane_spread);
+                    for (int lane = 0; lane < worlds; ++lane)
+                    {
+                        thread_sum[t] += lane_spread[lane];
+                        thread_sq_sum[t] += (double)lane_spread[lane] * lane_spread[lane];
+                    }
+                }
+                return;
+            }
+
+            // LT 模型：阈值在节点第一次被尝试激活时才抽取；scratch 数组用模拟编号（epoch）
+            // 标记有效性而不是每次清零，激活列表同时充当 BFS 队列，因此每次模拟的代价
+            // 只与被触及的节点数成正比。
+            vector<int> touched_epoch(n, 0), active_epoch(n, 0);
+            vector<double> thresholds(n), total_weights(n);
+            vector<int> activated_list;
+            int epoch = 0;
+            for (int64_t i = begin; i < end; ++i)
+            {
+                ++epoch;
+                activated_list.clear();
+
+                // 初始化种子节点
+                for (int seed : initial_nodes)
+                {
+                    // 【修改】如果种子节点本身被阻塞，它不能启动传播
+                    if (seed >= 0 && seed < n && !is_blocked[seed] && active_epoch[seed] != epoch)
+                    {
+                        active_epoch[seed] = epoch;
+                        activated_list.push_back(seed);
+                    }
+                }
+
+                for (size_t head = 0; head < activated_list.size(); ++head)
+                {
+                    int u = activated_list[head];
+
+                    for (size_t j = 0; j < g[u].size(); ++j)
+                    {
+                        int v = g[u][j];
+                        // 【修改】如果邻居已被激活或被阻塞（节点或边），则跳过
+                        if (active_epoch[v] == epoch || is_blocked[v] || is_edge_blocked(blocked_edges, u, j))
+                            continue;
+
+                        if (touched_epoch[v] != epoch)
+                        {
+                            touched_epoch[v] = epoch;
+                            thresholds[v] = sfmt_genrand_real1(&rng);
+                            total_weights[v] = 0.0;
+                        }
+                        total_weights[v] += (*active_probFwd)[u][j];
+
+                        if (total_weights[v] >= thresholds[v])
+                        {
+                            active_epoch[v] = epoch;
+                            activated_list.push_back(v);
+                        }
+                    }
+                }
+
+                // 统计本次模拟中所有被激活的节点
+                for (int v : activated_list)
+                    counts[v]++;
+                double spread = activated_list.size();
+                thread_sum[t] += spread;
+                thread_sq_sum[t] += spread * spread;
+            }
+        });
+
+        // --- 归约各线程的计数 ---
+        for (int t = 0; t < num_threads; ++t)
+        {
+            for (size_t j = 0; j < thread_counts[t].size(); ++j)
+                counts[j] += thread_counts[t][j];
+            spread_sum += thread_sum[t];
+            spread_sq_sum += thread_sq_sum[t];
+        }
+    }
+
+    // 双侧置信水平 confidence 对应的标准正态分位数 z，满足 erf(z / sqrt(2)) = confidence
+    static double normal_quantile(double confidence)
+    {
+        double lo = 0.0, hi = 10.0;
+        for (int it = 0; it < 100; ++it)
+        {
+            double mid = 0.5 * (lo + hi);
+            if (std::erf(mid / std::sqrt(2.0)) < confidence)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        return hi;
+    }
+
 public:
     InfluModel influModel;
     const vector<vector<double>> *active_probT = nullptr;
@@ -120,12 +403,87 @@ public:
     vector<vector<int>> hyperGT;
     vector<int> result_node_set;                            // 通用名，可用于种子集或阻塞集
     const vector<vector<double>> *active_probFwd = nullptr; // 【新增】用于前向模拟的概率指针
+    int num_threads = default_num_threads();                // 并行采样/模拟使用的线程数
+
+    // 概率波内核使用的入边 CSR：v 的入边为 [in_offset[v], in_offset[v+1])，in_src 为入邻居，
+    // in_edge 为边ID，in_weight 为当前概率模型下连续存放的边权（由 setActiveProbabilityModel 填充）
+    vector<int> in_offset, in_src, in_edge;
+    vector<double> in_weight;
 
     InfGraph(const string &graph_filepath) : Graph(graph_filepath)
     {
         sfmt_init_gen_rand(&sfmt, 1234);
     }
 
+    // 从主随机数流中取出一个种子，用于初始化并行任务中各线程独立的随机数流
+    uint32_t next_seed() { return sfmt_genrand_uint32(&sfmt); }
+
+    // --- 边阻塞掩码 ---
+    // 将边列表转换为以边ID为下标的阻塞掩码（同一对节点间的重边会一并阻塞），空列表返回空掩码
+    vector<char> make_edge_mask(const vector<Edge> &edges) const
+    {
+        vector<char> mask;
+        if (edges.empty())
+            return mask;
+        mask.assign(m, 0);
+        for (const Edge &e : edges)
+        {
+            if (e.source < 0 || e.source >= n)
+                continue;
+            for (size_t j = 0; j < g[e.source].size(); ++j)
+            {
+                if (g[e.source][j] == e.target)
+                    mask[out_offset[e.source] + j] = 1;
+            }
+        }
+        return mask;
+    }
+
+    // 边列表对应的全部边ID（与 make_edge_mask 一致，同一对节点间的重边都包含在内）
+    vector<int> edge_ids_of(const vector<Edge> &edges) const
+    {
+        vector<int> ids;
+        for (const Edge &e : edges)
+        {
+            if (e.source < 0 || e.source >= n)
+                continue;
+            for (size_t j = 0; j < g[e.source].size(); ++j)
+            {
+                if (g[e.source][j] == e.target)
+                    ids.push_back(out_offset[e.source] + j);
+            }
+        }
+        return ids;
+    }
+
+    // 按边ID构造阻塞掩码：只阻塞给定的边本身，不涉及重边
+    vector<char> make_edge_mask_from_ids(const vector<int> &edge_ids) const
+    {
+        vector<char> mask;
+        if (edge_ids.empty())
+            return mask;
+        mask.assign(m, 0);
+        for (int eid : edge_ids)
+        {
+            if (eid >= 0 && eid < m)
+                mask[eid] = 1;
+        }
+        return mask;
+    }
+
+    // 由边ID还原出 (source, target)
+    Edge edge_by_id(int eid) const
+    {
+        int u = std::upper_bound(out_offset.begin(), out_offset.end(), eid) - out_offset.begin() - 1;
+        return {u, g[u][eid - out_offset[u]]};
+    }
+
+    // 出边 g[u][j] 是否被阻塞
+    bool is_edge_blocked(const vector<char> &blocked_edges, int u, size_t j) const
+    {
+        return !blocked_edges.empty() && blocked_edges[out_offset[u] + j];
+    }
+
     // --- 模型与概率设置 ---
     void setInfuModel(InfluModel p) { influModel = p; }
     // 在 infgraph.h 的 class InfGraph 内部
@@ -151,6 +509,24 @@ public:
         {
             throw std::invalid_argument("Unknown probability model: " + model_name);
         }
+
+        if (in_offset.empty())
+        {
+            in_offset.assign(n + 1, 0);
+            for (int v = 0; v < n; ++v)
+                in_offset[v + 1] = in_offset[v] + gT[v].size();
+            in_src.reserve(in_offset[n]);
+            in_edge.reserve(in_offset[n]);
+            for (int v = 0; v < n; ++v)
+            {
+                in_src.insert(in_src.end(), gT[v].begin(), gT[v].end());
+                in_edge.insert(in_edge.end(), in_eid[v].begin(), in_eid[v].end());
+            }
+        }
+        in_weight.clear();
+        in_weight.reserve(in_offset[n]);
+        for (int v = 0; v < n; ++v)
+            in_weight.insert(in_weight.end(), (*active_probT)[v].begin(), (*active_probT)[v].end());
     }
     // --- 核心 RR Set/超图 操作 ---
     void init_hyper_graph()
@@ -193,115 +569,8 @@ public:
         }
     }
 
-    // 【新增】将这个完整的函数粘贴到 influence_calculator.cpp 的顶部区域
-    // 【替换】run_forward_simulation_with_parent_tracking 的完整实现
-    map<int, pair<int, double>> run_forward_simulation_with_tracking(const vector<int>& initial_nodes, const vector<int>& blocking_nodes) {
-        map<int, pair<int, double>> parent_map; // <子节点, {父节点, 边的概率}>
-        if (initial_nodes.empty()) return parent_map;
-
-        vector<bool> activated(n, false);
-        vector<bool> is_blocked(n, false);
-        for(int node : blocking_nodes) is_blocked[node] = true;
-
-        queue<int> q;
-        for (int seed : initial_nodes) {
-            if (!is_blocked[seed]) {
-                q.push(seed);
-                activated[seed] = true;
-                parent_map[seed] = {-1, 1.0}; // 种子节点没有父节点，概率设为1.0
-            }
-        }
-
-        if (influModel == LT) {
-            // LT模型的逻辑保持不变，因为它不依赖单边概率
-            vector<double> thresholds(n);
-            for(int i=0; i<n; ++i) thresholds[i] = sfmt_genrand_real1(&sfmt);
-            vector<double> total_weights(n, 0.0);
-            
-            queue<int> lt_q = q;
-            while(!lt_q.empty()){
-                int u = lt_q.front();
-                lt_q.pop();
-
-                for (size_t j = 0; j < g[u].size(); ++j) {
-                    int v = g[u][j];
-                    if (activated[v] || is_blocked[v]) continue;
-
-                    double weight = (*active_probFwd)[u][j];
-                    total_weights[v] += weight;
-
-                    if(total_weights[v] >= thresholds[v]){
-                        activated[v] = true;
-                        lt_q.push(v);
-                        if (!parent_map.count(v)) {
-                            parent_map[v] = {u, weight}; // 记录第一个激活它的边的权重
-                        }
-                    }
-                }
-            }
-        } else { // IC 和 WC 模型的模拟逻辑
-            while (!q.empty()) {
-                int u = q.front();
-                q.pop();
-
-                for (size_t j = 0; j < g[u].size(); ++j) {
-                    int v = g[u][j];
-                    if (activated[v] || is_blocked[v]) continue;
-
-                    double prob = (*active_probFwd)[u][j];
-                    if (sfmt_genrand_real1(&sfmt) < prob) {
-                        activated[v] = true;
-                        q.push(v);
-                        parent_map[v] = {u, prob}; // 【核心修改】同时记录父节点和边的概率
-                    }
-                }
-            }
-        }
-        return parent_map;
-    }
-
-
-    // 【替换】find_main_propagation_paths 的完整实现
-    vector<Edge> find_main_propagation_paths(const vector<int> &seed_nodes)
-    {
-        if (seed_nodes.empty())
-        {
-            return {};
-        }
-
-        // 1. 运行增强版的模拟，获取包含概率的父子关系图
-        map<int, pair<int, double>> parent_prob_map = run_forward_simulation_with_tracking(seed_nodes, {});
-        
-        // 2. 将 map 转换为一个可以排序的 vector
-        vector<pair<double, Edge>> weighted_edges;
-        for (auto const &[child, parent_info] : parent_prob_map)
-        {
-            int parent = parent_info.first;
-            double prob = parent_info.second;
-            if (parent != -1) // 排除种子节点
-            {
-                weighted_edges.push_back({prob, {parent, child}});
-            }
-        }
-
-        // 3. 按概率从高到低排序
-        std::sort(weighted_edges.begin(), weighted_edges.end(), 
-            [](const pair<double, Edge>& a, const pair<double, Edge>& b) {
-                return a.first > b.first; // 只比较概率（第一个元素），并按降序排列
-            }
-        );
-
-        // 4. 提取概率最高的边，最多不超过50条
-        vector<Edge> main_paths;
-        for (size_t i = 0; i < weighted_edges.size() && i < 50; ++i)
-        {
-            main_paths.push_back(weighted_edges[i].second);
-        }
-
-        return main_paths;
-    }
-
-    void build_blocking_set(int k, const vector<int> &negative_seeds)
+    // 返回被所选阻塞节点覆盖的“风险RR集”数量，可用于估算阻塞带来的影响力下降
+    int64_t build_blocking_set(int k, const vector<int> &negative_seeds)
     {
         result_node_set.clear();
 
@@ -356,6 +625,7 @@ public:
 
         // 4. 贪心选择覆盖最多“风险RR集”的阻塞节点
         vector<bool> covered(hyperGT.size(), false);
+        int64_t covered_count = 0;
         for (int i = 0; i < k && !degree_heap.empty(); i++)
         {
             int max_node = degree_heap.pop(); // 选出当前覆盖率最高的阻塞节点
@@ -367,6 +637,7 @@ public:
                 if (is_rr_risky[rr_idx] && !covered[rr_idx])
                 {
                     covered[rr_idx] = true;
+                    covered_count++;
                     for (int node_in_rr : hyperGT[rr_idx])
                     {
                         if (!is_negative_seed[node_in_rr] && !degree_heap.pos.notexist(node_in_rr))
@@ -378,144 +649,127 @@ public:
                 }
             }
         }
+        return covered_count;
     }
 
-    // 【新增】为IC模型优化的、带提前终止功能的RR set生成函数
-    void generate_rr_set_ic_stoppable(
+    // 带提前终止的RR集生成（IC/LT 通用，线程安全）：从 start_node 反向扩展，
+    // 一旦到达目标节点立即停止。生成的节点依次追加到 out 末尾（兼作BFS队列），
+    // visited 为调用方持有的线程私有标记数组，返回前会被复原。
+    void generate_rr_set_stoppable(
         int start_node,
-        int rr_set_idx,
-        const vector<bool> &is_target // 快速查找的目标集
-    )
+        const vector<char> &is_target, // 快速查找的目标集（只读，线程间共享）
+        sfmt_t *rng,
+        vector<char> &visited,
+        vector<int> &out) const
     {
-        if (is_target[start_node])
-        { // 如果起始点就是目标，直接完成
-            hyperGT[rr_set_idx].push_back(start_node);
-            hyperG[start_node].push_back(rr_set_idx);
-            return;
-        }
-
-        vector<int> q;
-        q.push_back(start_node);
-        hyperGT[rr_set_idx].push_back(start_node);
-        hyperG[start_node].push_back(rr_set_idx);
-
-        vector<bool> visited(n, false);
-        visited[start_node] = true;
-        int head = 0;
-
-        while (head < (int)q.size())
+        const size_t begin = out.size();
+        out.push_back(start_node);
+        if (!is_target[start_node])
         {
-            int u = q[head++];
-            for (size_t i = 0; i < gT[u].size(); ++i)
+            visited[start_node] = 1;
+            bool reached = false;
+            for (size_t head = begin; head < out.size() && !reached; ++head)
             {
-                int v = gT[u][i];
-                double p = (*active_probT)[u][i];
-
-                if (!visited[v] && sfmt_genrand_real1(&sfmt) < p)
+                int u = out[head];
+                if (influModel == LT)
                 {
-                    visited[v] = true;
-                    q.push_back(v);
-                    hyperGT[rr_set_idx].push_back(v);
-                    hyperG[v].push_back(rr_set_idx);
-
-                    // 【【核心优化】】
-                    // 如果新加入的节点是目标之一，立即停止扩展此RR set
-                    if (is_target[v])
+                    // LT的轮盘赌选择：至多选中一个入邻居
+                    if (gT[u].empty())
+                        continue;
+                    double rand_val = sfmt_genrand_real1(rng);
+                    for (size_t i = 0; i < gT[u].size(); ++i)
                     {
-                        return;
+                        rand_val -= (*active_probT)[u][i];
+                        if (rand_val <= 0)
+                        {
+                            int v = gT[u][i];
+                            if (!visited[v])
+                            {
+                                visited[v] = 1;
+                                out.push_back(v);
+                                reached = is_target[v];
+                            }
+                            break;
+                        }
                     }
                 }
-            }
-        }
-    }
-
-    // 【新增】为LT模型优化的、带提前终止功能的RR set生成函数
-    void generate_rr_set_lt_stoppable(
-        int start_node,
-        int rr_set_idx,
-        const vector<bool> &is_target)
-    {
-        if (is_target[start_node])
-        {
-            hyperGT[rr_set_idx].push_back(start_node);
-            hyperG[start_node].push_back(rr_set_idx);
-            return;
-        }
-
-        vector<int> q;
-        q.push_back(start_node);
-        hyperGT[rr_set_idx].push_back(start_node);
-        hyperG[start_node].push_back(rr_set_idx);
-
-        vector<bool> visited(n, false);
-        visited[start_node] = true;
-        int head = 0;
-
-        while (head < (int)q.size())
-        {
-            int u = q[head++];
-            if (gT[u].empty())
-                continue;
-
-            // ... (LT的轮盘赌选择逻辑不变) ...
-            double rand_val = sfmt_genrand_real1(&sfmt);
-            for (size_t i = 0; i < gT[u].size(); ++i)
-            {
-                double edge_weight = (*active_probT)[u][i];
-                rand_val -= edge_weight;
-                if (rand_val <= 0)
+                else
                 {
-                    int v = gT[u][i];
-                    if (!visited[v])
+                    for (size_t i = 0; i < gT[u].size(); ++i)
                     {
-                        visited[v] = true;
-                        q.push_back(v);
-                        hyperGT[rr_set_idx].push_back(v);
-                        hyperG[v].push_back(rr_set_idx);
-
-                        // 【【核心优化】】
-                        if (is_target[v])
+                        int v = gT[u][i];
+                        if (!visited[v] && sfmt_genrand_real1(rng) < (*active_probT)[u][i])
                         {
-                            return;
+                            visited[v] = 1;
+                            out.push_back(v);
+                            // 【核心优化】新加入的节点是目标之一，立即停止扩展此RR set
+                            if (is_target[v])
+                            {
+                                reached = true;
+                                break;
+                            }
                         }
                     }
-                    break;
                 }
             }
         }
+        for (size_t i = begin; i < out.size(); ++i)
+            visited[out[i]] = 0;
     }
 
     // --- 集合选择与影响力估算 ---
-    // 在 infgraph.h 的 class InfGraph 中
 
+    // 向现有超图中追加 R 个带提前终止的RR集，可多次调用以逐步扩充样本池。
+    // 各线程使用独立的随机数流和私有缓冲区并行采样，再按线程顺序合并，结果可复现。
     void build_hyper_graph_for_minimization(int64_t R, const vector<int> &negative_seeds)
     {
         assert(active_probT != nullptr && "Probability model must be set.");
-        if (hyperGT.capacity() < (size_t)R)
-            hyperGT.reserve(R);
+        if (R <= 0)
+            return;
 
         // 创建一个负面种子的快速查找表
-        vector<bool> is_negative_seed(n, false);
+        vector<char> is_negative_seed(n, 0);
         for (int seed : negative_seeds)
         {
             if (seed >= 0 && seed < n)
-                is_negative_seed[seed] = true;
+                is_negative_seed[seed] = 1;
         }
 
-        for (int i = 0; i < R; i++)
+        // 1. 并行采样到线程私有的扁平缓冲区
+        const uint32_t base_seed = next_seed();
+        vector<vector<int>> local_nodes(num_threads), local_offsets(num_threads);
+        parallel_for(R, num_threads, [&](int t, int64_t begin, int64_t end)
         {
-            hyperGT.push_back(vector<int>());
-            int random_node = sfmt_genrand_uint32(&sfmt) % n;
-
-            // 调用我们新增的、带提前终止优化的函数
-            if (influModel == IC || influModel == WC)
+            sfmt_t rng;
+            sfmt_init_gen_rand(&rng, base_seed + t);
+            vector<char> visited(n, 0);
+            vector<int> &nodes = local_nodes[t];
+            vector<int> &offsets = local_offsets[t];
+            offsets.reserve(end - begin + 1);
+            offsets.push_back(0);
+            for (int64_t i = begin; i < end; ++i)
             {
-                generate_rr_set_ic_stoppable(random_node, i, is_negative_seed);
+                int random_node = sfmt_genrand_uint32(&rng) % n;
+                generate_rr_set_stoppable(random_node, is_negative_seed, &rng, visited, nodes);
+                offsets.push_back(nodes.size());
             }
-            else if (influModel == LT)
+        });
+
+        // 2. 按线程顺序合并到超图
+        int64_t idx = hyperGT.size();
+        hyperGT.resize(idx + R);
+        for (size_t t = 0; t < local_offsets.size(); ++t)
+        {
+            const vector<int> &nodes = local_nodes[t];
+            const vector<int> &offsets = local_offsets[t];
+            for (size_t k = 0; k + 1 < offsets.size(); ++k, ++idx)
             {
-                generate_rr_set_lt_stoppable(random_node, i, is_negative_seed);
+                hyperGT[idx].assign(nodes.begin() + offsets[k], nodes.begin() + offsets[k + 1]);
+                for (int v : hyperGT[idx])
+                    hyperG[v].push_back(idx);
             }
+            vector<int>().swap(local_nodes[t]);
+            vector<int>().swap(local_offsets[t]);
         }
     }
 
@@ -589,45 +843,17 @@ public:
         return static_cast<double>(count) / hyperGT.size() * n;
     }
 
-    double estimate_influence(const vector<int> &seed_nodes, const vector<int> &blocking_nodes, int iterations = 200000)
-    {
-        init_hyper_graph();
-        build_hyper_graph_r(iterations);
-        vector<bool> covered(hyperGT.size(), false);
-        vector<bool> is_blocked_rr(hyperGT.size(), false);
-        for (int blocker : blocking_nodes)
-        {
-            for (int rr_set_idx : hyperG[blocker])
-            {
-                is_blocked_rr[rr_set_idx] = true;
-            }
-        }
-        int count = 0;
-        for (int seed : seed_nodes)
-        {
-            for (int rr_set_idx : hyperG[seed])
-            {
-                if (!is_blocked_rr[rr_set_idx] && !covered[rr_set_idx])
-                {
-                    covered[rr_set_idx] = true;
-                    count++;
-                }
-            }
-        }
-        return static_cast<double>(count) / hyperGT.size() * n;
-    }
-
+    // 蒙特卡洛估计每个节点的最终激活概率（固定模拟次数）
     vector<double> calculate_final_probabilities(
         const vector<int> &initial_nodes,
         int num_simulations,
-        const vector<int> &blocking_nodes = {} // 【新增】第三个参数
+        const vector<int> &blocking_nodes = {}, // 【新增】第三个参数
+        const vector<char> &blocked_edges = {}  // 以边ID为下标的阻塞掩码
     )
     {
         assert(active_probFwd != nullptr && "Forward probability model must be set.");
         assert(num_simulations > 0 && "Number of simulations must be positive.");
 
-        vector<double> influence_counts(n, 0.0);
-
         // 【新增】创建一个快速查找表来标记阻塞节点
         vector<bool> is_blocked(n, false);
         for (int node : blocking_nodes)
@@ -636,99 +862,81 @@ public:
                 is_blocked[node] = true;
         }
 
-        // --- 主循环：执行 num_simulations 次独立的模拟 ---
-        for (int i = 0; i < num_simulations; ++i)
-        {
-            vector<bool> activated(n, false);
-            queue<int> q;
+        vector<int64_t> counts(n, 0);
+        double spread_sum = 0.0, spread_sq_sum = 0.0;
+        accumulate_simulations(initial_nodes, num_simulations, is_blocked, blocked_edges, counts, spread_sum, spread_sq_sum);
 
-            // 初始化种子节点
-            for (int seed : initial_nodes)
-            {
-                // 【修改】如果种子节点本身被阻塞，它不能启动传播
-                if (seed >= 0 && seed < n && !is_blocked[seed] && !activated[seed])
-                {
-                    activated[seed] = true;
-                    q.push(seed);
-                }
-            }
-
-            // --- 根据不同的模型执行单次模拟 ---
-            if (influModel == LT)
-            {
-                // LT 模型模拟逻辑
-                vector<double> thresholds(n);
-                for (int j = 0; j < n; ++j)
-                {
-                    thresholds[j] = sfmt_genrand_real1(&sfmt);
-                }
-                vector<double> total_weights(n, 0.0);
-
-                queue<int> lt_q = q; // 为LT创建一个单独的队列副本
-                while (!lt_q.empty())
-                {
-                    int u = lt_q.front();
-                    lt_q.pop();
+        // --- 计算最终的概率期望 ---
+        vector<double> influence_counts(n, 0.0);
+        for (int j = 0; j < n; ++j)
+        {
+            influence_counts[j] = (double)counts[j] / num_simulations;
+        }
 
-                    for (size_t j = 0; j < g[u].size(); ++j)
-                    {
-                        int v = g[u][j];
-                        // 【修改】如果邻居已被激活或被阻塞，则跳过
-                        if (activated[v] || is_blocked[v])
-                            continue;
+        return influence_counts;
+    }
 
-                        double weight = (*active_probFwd)[u][j];
-                        total_weights[v] += weight;
+    // 自适应蒙特卡洛估计：按批次执行模拟，直到平均传播规模在置信水平 confidence 下的
+    // 置信区间半宽不超过 relative_error 倍的估计值，或达到 max_simulations 次为止。
+    // threshold 在 (0,1) 内时还要求每个节点相对该激活阈值的判定已确定（置信区间不含阈值），
+    // 或其概率的置信区间半宽不超过 relative_error（按绝对误差计）。
+    AdaptiveEstimate calculate_final_probabilities_adaptive(
+        const vector<int> &initial_nodes,
+        double relative_error = 0.02,
+        double confidence = 0.95,
+        int max_simulations = 10000,
+        const vector<int> &blocking_nodes = {},
+        const vector<char> &blocked_edges = {},
+        double threshold = -1.0)
+    {
+        assert(active_probFwd != nullptr && "Forward probability model must be set.");
+        assert(max_simulations > 0 && "Number of simulations must be positive.");
+        assert(relative_error > 0 && confidence > 0 && confidence < 1);
 
-                        if (total_weights[v] >= thresholds[v])
-                        {
-                            activated[v] = true;
-                            lt_q.push(v);
-                        }
-                    }
-                }
-            }
-            else
-            { // IC 模型的模拟逻辑
-                while (!q.empty())
-                {
-                    int u = q.front();
-                    q.pop();
+        vector<bool> is_blocked(n, false);
+        for (int node : blocking_nodes)
+        {
+            if (node >= 0 && node < n)
+                is_blocked[node] = true;
+        }
 
-                    for (size_t j = 0; j < g[u].size(); ++j)
-                    {
-                        int v = g[u][j];
-                        // 【修改】如果邻居已被激活或被阻塞，则跳过
-                        if (activated[v] || is_blocked[v])
-                            continue;
+        const double z = normal_quantile(confidence);
+        const int64_t batch = max<int64_t>(512, 64 * (int64_t)num_threads);
+        const bool check_nodes = threshold > 0.0 && threshold < 1.0;
 
-                        double prob = (*active_probFwd)[u][j];
-                        if (sfmt_genrand_real1(&sfmt) < prob)
-                        {
-                            activated[v] = true;
-                            q.push(v);
-                        }
-                    }
-                }
-            }
+        AdaptiveEstimate est;
+        vector<int64_t> counts(n, 0);
+        double spread_sum = 0.0, spread_sq_sum = 0.0;
+        int64_t done = 0;
+        while (done < max_simulations)
+        {
+            int64_t step = min<int64_t>(batch, max_simulations - done);
+            accumulate_simulations(initial_nodes, step, is_blocked, blocked_edges, counts, spread_sum, spread_sq_sum);
+            done += step;
+
+            double mean = spread_sum / done;
+            double var = done > 1 ? max(0.0, (spread_sq_sum - done * mean * mean) / (done - 1)) : 0.0;
+            est.spread = mean;
+            est.half_width = z * std::sqrt(var / done);
+            if (est.half_width > relative_error * mean)
+                continue;
 
-            // 统计本次模拟中所有被激活的节点
-            for (int j = 0; j < n; ++j)
+            bool settled = true;
+            for (int v = 0; check_nodes && settled && v < n; ++v)
             {
-                if (activated[j])
-                {
-                    influence_counts[j]++;
-                }
+                double p = (double)counts[v] / done;
+                double h = z * std::sqrt(p * (1.0 - p) / done);
+                settled = std::fabs(p - threshold) > h || h <= relative_error;
             }
+            if (settled)
+                break;
         }
 
-        // --- 计算最终的概率期望 ---
-        for (int j = 0; j < n; ++j)
-        {
-            influence_counts[j] /= num_simulations;
-        }
-
-        return influence_counts;
+        est.simulations = (int)done;
+        est.probabilities.assign(n, 0.0);
+        for (int v = 0; v < n; ++v)
+            est.probabilities[v] = (double)counts[v] / done;
+        return est;
     }
 
     // in infgraph.h, inside class InfGraph
@@ -736,6 +944,7 @@ public:
     ApiSimulationResult run_probability_simulation(
         const vector<int> &initial_nodes,
         const vector<int> &blocking_nodes = {},
+        const vector<char> &blocked_edges = {},
         int max_steps = 10,
         double threshold = 0.5,
         double stop_delta = 1e-6)
@@ -752,9 +961,27 @@ public:
                 is_blocked[node] = true;
         }
     
-        vector<double> current_prob(n, 0.0);
-        vector<double> next_prob(n, 0.0);
-    
+        // 只重算上一步有入邻居概率发生变化的节点（脏节点），其余节点的输入未变，概率也不变。
+        // 每步先基于旧概率算出全部脏节点的新值，再统一写回（与整图同步迭代的结果一致）。
+        vector<double> prob(n, 0.0);
+        vector<int> changed_nodes; // 上一步概率发生变化的节点
+
+        // 被删除的边以权重 0 参与计算，内核中不需要分支
+        const double *weights = in_weight.data();
+        vector<double> masked_weights;
+        if (!blocked_edges.empty())
+        {
+            masked_weights = in_weight;
+            for (size_t k = 0; k < masked_weights.size(); ++k)
+            {
+                if (blocked_edges[in_edge[k]])
+                    masked_weights[k] = 0.0;
+            }
+            weights = masked_weights.data();
+        }
+        vector<int> dirty_stamp(n, 0), dirty;
+        vector<double> new_values;
+
         // --- Step 0: 初始化 ---
         SimulationStep step0;
         step0.step = 0;
@@ -762,7 +989,9 @@ public:
         {
             if (seed >= 0 && seed < n && !is_blocked[seed])
             {
-                next_prob[seed] = 1.0;
+                if (prob[seed] != 1.0)
+                    changed_nodes.push_back(seed);
+                prob[seed] = 1.0;
                 step0.node_states.push_back({seed, "active", 1.0});
             }
         }
@@ -771,50 +1000,49 @@ public:
         // --- 迭代传播 ---
         for (int i = 1; i < max_steps; ++i)
         {
-            current_prob = next_prob;
-            bool changed = false;
-    
-            // IC 和 LT 模型的迭代逻辑 (这部分不变)
-            if (influModel == IC)
+            // 1. 收集脏节点：上一步变化节点的（未被删除边相连的）出邻居，按ID排序以保持快照顺序
+            dirty.clear();
+            for (int u : changed_nodes)
             {
-                // ... IC 逻辑 (无变化)
-                for (int v = 0; v < n; ++v)
+                for (size_t j = 0; j < g[u].size(); ++j)
                 {
-                    if (is_blocked[v] || current_prob[v] > 1.0 - stop_delta) {
-                        next_prob[v] = current_prob[v];
-                        continue;
-                    }
-                    double p_not_activated = 1.0;
-                    for (size_t j = 0; j < gT[v].size(); ++j) {
-                        int u = gT[v][j];
-                        double edge_prob = (*active_probT)[v][j];
-                        p_not_activated *= (1.0 - current_prob[u] * edge_prob);
-                    }
-                    next_prob[v] = 1.0 - p_not_activated;
-                    if (abs(next_prob[v] - current_prob[v]) > stop_delta) {
-                        changed = true;
+                    int v = g[u][j];
+                    if (dirty_stamp[v] != i && !is_edge_blocked(blocked_edges, u, j))
+                    {
+                        dirty_stamp[v] = i;
+                        dirty.push_back(v);
                     }
                 }
             }
-            else if (influModel == LT)
+            std::sort(dirty.begin(), dirty.end());
+
+            // 2. 基于旧概率计算脏节点的新概率（向量化内核；脏节点较多时按节点分段多线程计算）
+            new_values.resize(dirty.size());
+            parallel_for(dirty.size(), dirty.size() >= 4096 ? num_threads : 1, [&](int, int64_t begin, int64_t end)
             {
-                // ... LT 逻辑 (无变化)
-                for (int v = 0; v < n; ++v)
+                for (int64_t k = begin; k < end; ++k)
                 {
-                    if (is_blocked[v] || current_prob[v] > 1.0 - stop_delta) {
-                        next_prob[v] = current_prob[v];
+                    int v = dirty[k];
+                    new_values[k] = prob[v];
+                    if (is_blocked[v] || prob[v] > 1.0 - stop_delta)
                         continue;
-                    }
-                    double sum_prob = 0.0;
-                    for (size_t j = 0; j < gT[v].size(); ++j) {
-                        int u = gT[v][j];
-                        double edge_weight = (*active_probT)[v][j];
-                        sum_prob += current_prob[u] * edge_weight;
-                    }
-                    next_prob[v] = std::min(1.0, sum_prob);
-                    if (abs(next_prob[v] - current_prob[v]) > stop_delta) {
-                        changed = true;
-                    }
+
+                    const int first = in_offset[v];
+                    const int len = in_offset[v + 1] - first;
+                    if (influModel == IC)
+                        new_values[k] = 1.0 - wave_kernels::ic_not_activated(in_src.data() + first, weights + first, len, prob.data());
+                    else if (influModel == LT)
+                        new_values[k] = std::min(1.0, wave_kernels::lt_weighted_sum(in_src.data() + first, weights + first, len, prob.data()));
+                }
+            });
+
+            bool changed = false;
+            for (size_t k = 0; k < dirty.size(); ++k)
+            {
+                if (abs(new_values[k] - prob[dirty[k]]) > stop_delta)
+                {
+                    changed = true;
+                    break;
                 }
             }
     
@@ -822,14 +1050,16 @@ public:
             if (!changed)
                 break;
     
-            // --- 记录当前步骤的快照 ---
+            // --- 记录当前步骤的快照（只需检查脏节点），并写回新概率 ---
             SimulationStep current_step;
             current_step.step = i;
+            changed_nodes.clear();
     
-            for (int node_id = 0; node_id < n; ++node_id)
+            for (size_t k = 0; k < dirty.size(); ++k)
             {
-                double new_p = next_prob[node_id];
-                double old_p = current_prob[node_id];
+                int node_id = dirty[k];
+                double new_p = new_values[k];
+                double old_p = prob[node_id];
     
                 // 记录有变化的节点
                 if (abs(new_p - old_p) > stop_delta || (old_p < threshold && new_p >= threshold))
@@ -843,6 +1073,12 @@ public:
                 {
                     current_step.newly_activated_nodes.push_back(node_id);
                 }
+
+                if (new_p != old_p)
+                {
+                    changed_nodes.push_back(node_id);
+                    prob[node_id] = new_p;
+                }
             }
             
             // 如果当前步骤有变化，则记录下来
@@ -860,7 +1096,8 @@ public:
         return result;
     }
 
-    vector<int> generate_random_seeds(int k)
+    // 只读取节点数，使用局部随机数生成器，不改动图的 sfmt 状态，可在共享的图上并发调用
+    vector<int> generate_random_seeds(int k) const
     {
         vector<int> seeds;
         if (k <= 0)
@@ -926,146 +1163,5 @@ public:
 
         return seeds;
     }
-
-    vector<Edge> find_cut_off_edges( // 函数名也修改以反映新功能
-        const vector<int> &negative_seeds,
-        const vector<int> &blocking_nodes)
-    {
-        vector<Edge> cut_off_edges;
-        if (negative_seeds.empty())
-            return cut_off_edges;
-
-        // --- 1. 模拟“阻塞前”的传播，并记录父子关系 ---
-        map<int, int> original_parent_map = this->run_forward_simulation_with_parent_tracking(negative_seeds, {});
-        if (original_parent_map.empty())
-            return cut_off_edges;
-
-        // --- 2. 模拟“阻塞后”的传播，记录激活状态 ---
-        vector<double> after_probs = this->calculate_final_probabilities(negative_seeds, 1, blocking_nodes);
-        vector<bool> is_activated_after_blocking(n, false);
-        for (size_t j = 0; j < after_probs.size(); ++j)
-        {
-            if (after_probs[j] > 0.5)
-            {
-                is_activated_after_blocking[j] = true;
-            }
-        }
-
-        // --- 3. 对比，找出被切断的边 ---
-        // 遍历原始传播中的所有“父 -> 子”关系
-        for (auto const &[child, parent] : original_parent_map)
-        {
-            // 种子节点的父是-1，不是一条真实的边，跳过
-            if (parent == -1)
-                continue;
-
-            // 【核心逻辑】
-            // 如果一个孩子节点在原始传播中被激活，但在阻塞后未能被激活，
-            // 那么，激活它的那条边 parent -> child 就是一条被切断的关键边。
-            if (!is_activated_after_blocking[child])
-            {
-                cut_off_edges.push_back({parent, child});
-            }
-        }
-
-        return cut_off_edges;
-    }
-
-    map<int, int> run_forward_simulation_with_parent_tracking(
-        const vector<int> &initial_nodes,
-        const vector<int> &blocking_nodes = {})
-    {
-        map<int, int> parent_map;
-        if (initial_nodes.empty())
-            return parent_map;
-
-        assert(active_probFwd != nullptr && "Forward probability model must be set for simulation.");
-
-        vector<bool> is_blocked(n, false);
-        for (int node : blocking_nodes)
-        {
-            if (node >= 0 && node < n)
-                is_blocked[node] = true;
-        }
-
-        vector<bool> activated(n, false);
-        queue<int> q;
-
-        // 初始化种子节点
-        for (int seed : initial_nodes)
-        {
-            if (seed >= 0 && seed < n && !is_blocked[seed] && !activated[seed])
-            {
-                activated[seed] = true;
-                q.push(seed);
-                parent_map[seed] = -1; // 标记为根节点
-            }
-        }
-
-        // --- 根据不同的模型执行单次模拟，并记录父节点 ---
-        if (influModel == LT)
-        {
-            // LT 模型模拟逻辑
-            vector<double> thresholds(n);
-            for (int j = 0; j < n; ++j)
-            {
-                thresholds[j] = sfmt_genrand_real1(&sfmt);
-            }
-            vector<double> total_weights(n, 0.0);
-
-            queue<int> lt_q = q;
-            while (!lt_q.empty())
-            {
-                int u = lt_q.front();
-                lt_q.pop();
-
-                for (size_t j = 0; j < g[u].size(); ++j)
-                {
-                    int v = g[u][j];
-                    if (activated[v] || is_blocked[v])
-                        continue;
-
-                    double weight = (*active_probFwd)[u][j];
-                    total_weights[v] += weight;
-
-                    if (total_weights[v] >= thresholds[v])
-                    {
-                        activated[v] = true;
-                        lt_q.push(v);
-                        // 记录第一个使节点跨过阈值的邻居为父节点
-                        if (!parent_map.count(v))
-                        {
-                            parent_map[v] = u;
-                        }
-                    }
-                }
-            }
-        }
-        else
-        { // IC 和 WC 模型的模拟逻辑
-            while (!q.empty())
-            {
-                int u = q.front();
-                q.pop();
-
-                for (size_t j = 0; j < g[u].size(); ++j)
-                {
-                    int v = g[u][j];
-                    if (activated[v] || is_blocked[v])
-                        continue;
-
-                    double prob = (*active_probFwd)[u][j];
-                    if (sfmt_genrand_real1(&sfmt) < prob)
-                    {
-                        activated[v] = true;
-                        q.push(v);
-                        parent_map[v] = u; // IC 模型中父子关系明确
-                    }
-                }
-            }
-        }
-
-        return parent_map;
-    }
 };
 #endif
@@ -3,6 +3,9 @@
 #include <stdexcept>
 #include <string>
 #include <set>
+#include <memory>
+#include <mutex>
+#include <deque>
 #include <uuid/uuid.h>
 #include "imm.h"
 
@@ -22,6 +25,132 @@ std::string generate_uuid() {
     return std::string(uuid_str);
 }
 
+// 交互式查询使用的预采样世界数（与原先每次查询的模拟次数一致）
+static const int NUM_CACHED_WORLDS = 10000;
+// 快速影响力估计（estimator = "RR"）使用的 RR 集数量
+static const int64_t NUM_CACHED_RR_SETS = 1 << 17;
+// 剪枝蒙特卡洛（estimator = "PMC"）使用的缩点世界数
+static const int NUM_CACHED_PMC_WORLDS = 2000;
+// 主要传播路径/被切断路径的边流量估计使用的世界数，以及返回的边数上限
+static const int NUM_FLOW_SAMPLES = 2000;
+static const int MAX_FLOW_EDGES = 50;
+
+// 一个 (数据集, 传播模型, 概率模型) 组合对应的图，以及按需构建的各类样本
+// 图在构建后只读：各类样本由缓存项中固定的种子派生，不再推进图内部的随机数状态，
+// 因此可以被并发请求同时读取和复制
+struct CachedWorlds {
+    shared_ptr<const InfGraph> graph;
+    shared_ptr<const WorldStore> worlds;
+    shared_ptr<const RRSpreadEstimator> rr_pool;
+    shared_ptr<const PrunedMonteCarlo> pmc;
+};
+
+// 需要缓存构建的样本类型
+enum CachedSampleKind { SAMPLED_WORLDS, RR_POOL, PMC_WORLDS };
+
+// 缓存表中的一项：样本的构建在项内的互斥量下进行，全局互斥量只保护查表与插入，
+// 因此某个组合首次构建样本时不会阻塞其他组合的请求。
+struct CachedModelEntry {
+    std::mutex build_mutex;
+    CachedWorlds data;
+    uint32_t worlds_seed = 0, rr_seed = 0, pmc_seed = 0; // 加载图时一次性抽取
+};
+
+// 辅助函数：按 (数据集, 传播模型, 概率模型) 取出缓存的图，并按需构建所需的样本。
+// 同一组合的所有查询共享这些样本，因此相同输入总是得到相同结果。
+static CachedWorlds get_cached_model(const string& dataset_id, const string& propagation_model, const string& probability_model,
+                                     CachedSampleKind kind) {
+    static std::mutex cache_mutex;
+    static map<string, shared_ptr<CachedModelEntry>> cache;
+
+    const string key = dataset_id + "|" + propagation_model + "|" + probability_model;
+    shared_ptr<CachedModelEntry> entry;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        shared_ptr<CachedModelEntry>& slot = cache[key];
+        if (!slot) {
+            slot = std::make_shared<CachedModelEntry>();
+        }
+        entry = slot;
+    }
+
+    std::lock_guard<std::mutex> lock(entry->build_mutex);
+    CachedWorlds& data = entry->data;
+    if (!data.graph) {
+        std::string graph_filepath = "./" + dataset_id + "_subset_1000.txt";
+        auto g = std::make_shared<InfGraph>(graph_filepath);
+        g->setInfuModel(model_str_to_enum(propagation_model));
+        g->setActiveProbabilityModel(probability_model);
+        entry->worlds_seed = g->next_seed();
+        entry->rr_seed = g->next_seed();
+        entry->pmc_seed = g->next_seed();
+        data.graph = g;
+    }
+    if (kind == SAMPLED_WORLDS && !data.worlds) {
+        data.worlds = std::make_shared<const WorldStore>(*data.graph, NUM_CACHED_WORLDS, entry->worlds_seed);
+    }
+    if (kind == RR_POOL && !data.rr_pool) {
+        data.rr_pool = std::make_shared<const RRSpreadEstimator>(*data.graph, NUM_CACHED_RR_SETS, entry->rr_seed);
+    }
+    if (kind == PMC_WORLDS && !data.pmc) {
+        data.pmc = std::make_shared<const PrunedMonteCarlo>(*data.graph, NUM_CACHED_PMC_WORLDS, entry->pmc_seed);
+    }
+    return data;
+}
+
+static CachedWorlds get_cached_worlds(const string& dataset_id, const string& propagation_model, const string& probability_model) {
+    return get_cached_model(dataset_id, propagation_model, probability_model, SAMPLED_WORLDS);
+}
+
+static CachedWorlds get_cached_rr_pool(const string& dataset_id, const string& propagation_model, const string& probability_model) {
+    return get_cached_model(dataset_id, propagation_model, probability_model, RR_POOL);
+}
+
+// 只依赖图结构的全图快照及其上的社区索引，按数据集缓存（与传播/概率模型无关），首次使用时构建
+struct CachedStructure {
+    shared_ptr<const LocalGraph> snapshot;
+    shared_ptr<const CoreIndex> core;
+    shared_ptr<const TrussIndex> truss;
+    shared_ptr<const DCoreIndex> dcore;
+};
+
+// 需要缓存构建的结构索引类型
+enum StructureIndexKind { CORE_INDEX, TRUSS_INDEX, DCORE_INDEX };
+
+static CachedStructure get_cached_structure(const string& dataset_id, const Graph& g, StructureIndexKind kind) {
+    static std::mutex structure_mutex;
+    static map<string, CachedStructure> cache;
+
+    std::lock_guard<std::mutex> lock(structure_mutex);
+    CachedStructure& entry = cache[dataset_id];
+    if (!entry.snapshot) {
+        vector<int> all_nodes(g.n);
+        std::iota(all_nodes.begin(), all_nodes.end(), 0);
+        auto snapshot = std::make_shared<LocalGraph>();
+        snapshot->build(g, all_nodes);
+        entry.snapshot = snapshot;
+    }
+    if (kind == CORE_INDEX && !entry.core) {
+        entry.core = std::make_shared<const CoreIndex>(*entry.snapshot);
+    }
+    if (kind == TRUSS_INDEX && !entry.truss) {
+        entry.truss = std::make_shared<const TrussIndex>(entry.snapshot);
+    }
+    if (kind == DCORE_INDEX && !entry.dcore) {
+        entry.dcore = std::make_shared<const DCoreIndex>(entry.snapshot);
+    }
+    return entry;
+}
+
+static vector<Edge> edges_from_ids(const InfGraph& g, const vector<int>& edge_ids) {
+    vector<Edge> edges;
+    edges.reserve(edge_ids.size());
+    for (int eid : edge_ids) {
+        edges.push_back(g.edge_by_id(eid));
+    }
+    return edges;
+}
+
 // in influence_calculator.cpp
 
 // 【用这个完整版本替换现有的 run_influence_maximization 函数】
@@ -57,10 +186,17 @@ ApiResult run_influence_maximization(const ApiRequest& request) {
     // double influence_spread_estimate = g.InfluenceHyperGraph(); 
 
     // 步骤 3: 【采用】与可视化一致的精确模拟法来【计算】影响力
-    const int NUM_SIMULATIONS_FOR_ACCURACY = 10000;
+    //         模拟按批进行，传播规模与阈值附近节点的判定都足够确定后提前停止
+    const int NUM_SIMULATIONS_FOR_ACCURACY = 10000; // 模拟次数上限
     const double ACTIVATION_THRESHOLD = 0.5;
-
-    vector<double> final_probs = g.calculate_final_probabilities(seed_node_ids, NUM_SIMULATIONS_FOR_ACCURACY, {});
+    double mc_error = request.params.mc_error > 0 ? request.params.mc_error : 0.02;
+    double mc_confidence = (request.params.mc_confidence > 0 && request.params.mc_confidence < 1) ? request.params.mc_confidence : 0.95;
+
+    AdaptiveEstimate estimate = g.calculate_final_probabilities_adaptive(
+        seed_node_ids, mc_error, mc_confidence,
+        NUM_SIMULATIONS_FOR_ACCURACY, {}, {}, ACTIVATION_THRESHOLD);
+    const vector<double>& final_probs = estimate.probabilities;
+    result.simulations_used = estimate.simulations;
     int accurate_influence_count = 0;
     for (double prob : final_probs) {
         if (prob >= ACTIVATION_THRESHOLD) {
@@ -74,14 +210,17 @@ ApiResult run_influence_maximization(const ApiRequest& request) {
     // ================= 【核心修改结束】 =================
 
 
-    // 步骤 4: 查找主要传播路径 (这部分不变)
-    result.main_propagation_paths = g.find_main_propagation_paths(seed_node_ids);
+    // 步骤 4: 主要传播路径：在一批采样世界上统计每条边作为激活边的次数（边流量），取流量最大的边
+    WorldStore flow_worlds(g, NUM_FLOW_SAMPLES);
+    CascadeStatistics flow = collect_cascade_statistics(flow_worlds, g, seed_node_ids, {}, {}, g.num_threads);
+    result.main_propagation_paths = edges_from_ids(g, top_flow_edges(flow, MAX_FLOW_EDGES));
 
     // 步骤 5: 更新返回消息，现在不再是 "estimated"
     result.message = "Influence maximization complete. Using propagation model '" + arg.model 
                    + "' and probability model '" + request.params.probability_model
                    + "'. Selected " + std::to_string(arg.k) 
-                   + " seed nodes, resulting in a simulated influence of " + std::to_string(result.final_influence.count) + " nodes.";
+                   + " seed nodes, resulting in a simulated influence of " + std::to_string(result.final_influence.count) + " nodes"
+                   + " (" + std::to_string(result.simulations_used) + " simulations).";
     return result;
 }
 
@@ -132,11 +271,17 @@ ApiMinResult run_influence_minimization(const ApiRequest& request) {
     
     // ================= 【核心修改开始】 =================
     // 我们将使用更精确的蒙特卡洛模拟来计算影响力数值，以确保与可视化结果一致。
-    const int NUM_SIMULATIONS_FOR_ACCURACY = 10000; // 定义一个用于精确计数的模拟次数
+    const int NUM_SIMULATIONS_FOR_ACCURACY = 10000; // 自适应模拟的次数上限
     const double ACTIVATION_THRESHOLD = 0.5;      // 定义节点被视为“激活”的概率阈值
-
-    // 2. 估算阻塞前影响力 (使用新的精确模拟法)
-    vector<double> probs_before = g.calculate_final_probabilities(negative_seeds, NUM_SIMULATIONS_FOR_ACCURACY, {});
+    double mc_error = request.params.mc_error > 0 ? request.params.mc_error : 0.02;
+    double mc_confidence = (request.params.mc_confidence > 0 && request.params.mc_confidence < 1) ? request.params.mc_confidence : 0.95;
+
+    // 2. 估算阻塞前影响力 (使用新的精确模拟法，误差足够小时提前停止)
+    AdaptiveEstimate estimate_before = g.calculate_final_probabilities_adaptive(
+        negative_seeds, mc_error, mc_confidence,
+        NUM_SIMULATIONS_FOR_ACCURACY, {}, {}, ACTIVATION_THRESHOLD);
+    const vector<double>& probs_before = estimate_before.probabilities;
+    result.simulations_before = estimate_before.simulations;
     int influence_count_before = 0;
     for (double prob : probs_before) {
         if (prob >= ACTIVATION_THRESHOLD) {
@@ -148,17 +293,39 @@ ApiMinResult run_influence_minimization(const ApiRequest& request) {
 
     int budget = request.params.budget;
     
-    // 3. 构建超图以【寻找】阻塞节点 (这部分仍然使用快速的IMM/RR集方法，因为它的目的是“寻找”最优集合，速度是关键)
-    int64_t R = 100000; 
-    g.init_hyper_graph();
-    g.build_hyper_graph_for_minimization(R, negative_seeds);
-
-    // 4. 选择阻塞节点 (这部分不变)
-    g.build_blocking_set(budget, negative_seeds);
+    // 3. & 4. 选择阻塞节点（或边阻塞模式下待删除的边）
+    const int NUM_LIVE_EDGE_SAMPLES = 2000;
+    vector<char> blocked_edge_mask;
+    if (request.params.blocking_type == "EDGE") {
+        // 基于活跃边样本支配树的贪心删边
+        vector<double> gains;
+        vector<int> edge_ids = DominatorBlocker::select_edges(g, negative_seeds, budget, NUM_LIVE_EDGE_SAMPLES, gains);
+        for (int eid : edge_ids) {
+            result.blocking_edges.push_back(g.edge_by_id(eid));
+        }
+        // 掩码直接由选中的边ID构造：(source, target) 只用于返回，按节点对还原会把重边一并阻塞
+        blocked_edge_mask = g.make_edge_mask_from_ids(edge_ids);
+        g.result_node_set.clear();
+        result.rr_sample_size = NUM_LIVE_EDGE_SAMPLES;
+    } else if (request.params.blocking_engine == "DOMINATOR") {
+        // 基于活跃边样本支配树的贪心选择
+        DominatorBlocker::select(g, negative_seeds, budget, NUM_LIVE_EDGE_SAMPLES);
+        result.rr_sample_size = NUM_LIVE_EDGE_SAMPLES;
+    } else {
+        // 自适应地扩充RR集样本池，样本量由估计的稳定程度决定
+        double relative_error = request.params.relative_error > 0 ? request.params.relative_error : 0.1;
+        MinimizationStats stats = Imm::InfluenceMinimize(g, negative_seeds, budget, relative_error);
+        result.rr_sample_size = stats.R;
+        result.sample_confidence = stats.confidence;
+    }
     vector<int> blocking_nodes = g.result_node_set;
 
     // 5. 估算阻塞后影响力 (同样使用新的精确模拟法)
-    vector<double> probs_after = g.calculate_final_probabilities(negative_seeds, NUM_SIMULATIONS_FOR_ACCURACY, blocking_nodes);
+    AdaptiveEstimate estimate_after = g.calculate_final_probabilities_adaptive(
+        negative_seeds, mc_error, mc_confidence,
+        NUM_SIMULATIONS_FOR_ACCURACY, blocking_nodes, blocked_edge_mask, ACTIVATION_THRESHOLD);
+    const vector<double>& probs_after = estimate_after.probabilities;
+    result.simulations_after = estimate_after.simulations;
     int influence_count_after = 0;
     for (double prob : probs_after) {
         if (prob >= ACTIVATION_THRESHOLD) {
@@ -168,7 +335,11 @@ ApiMinResult run_influence_minimization(const ApiRequest& request) {
     result.influence_after.count = influence_count_after;
     result.influence_after.ratio = (g.n > 0) ? (static_cast<double>(influence_count_after) / g.n) : 0.0;
     
-    result.cut_off_paths = g.find_cut_off_edges(negative_seeds, blocking_nodes);
+    // 6. 被切断的传播路径：在同一批采样世界上比较阻塞前后的边流量，取下降最多的边
+    WorldStore flow_worlds(g, NUM_FLOW_SAMPLES);
+    CascadeStatistics flow_before = collect_cascade_statistics(flow_worlds, g, negative_seeds, {}, {}, g.num_threads);
+    CascadeStatistics flow_after = collect_cascade_statistics(flow_worlds, g, negative_seeds, blocking_nodes, blocked_edge_mask, g.num_threads);
+    result.cut_off_paths = edges_from_ids(g, top_flow_drop_edges(flow_before, flow_after, MAX_FLOW_EDGES));
     
     // 7. 填充所有返回字段 (这部分不变)
     result.original_result_id = generate_uuid();
@@ -184,27 +355,52 @@ ApiMinResult run_influence_minimization(const ApiRequest& request) {
         result.reduction_ratio = 0.0;
     }
     
-    result.message = "Influence minimization complete. Selected " + std::to_string(budget)
-                   + " blocking nodes, reducing influence by approximately " + std::to_string(result.reduction_ratio * 100) 
-                   + "%. Found " + std::to_string(result.cut_off_paths.size()) + " sample cut-off paths.";
+    string blocked_what = (request.params.blocking_type == "EDGE")
+                        ? std::to_string(result.blocking_edges.size()) + " blocking edges"
+                        : std::to_string(blocking_nodes.size()) + " blocking nodes";
+    result.message = "Influence minimization complete. Selected " + blocked_what
+                   + ", reducing influence by approximately " + std::to_string(result.reduction_ratio * 100) 
+                   + "%. Found " + std::to_string(result.cut_off_paths.size()) + " sample cut-off paths"
+                   + " (" + std::to_string(result.rr_sample_size) + " samples, confidence "
+                   + std::to_string(result.sample_confidence) + ").";
 
     return result;
 }
 // --- 【新增】为MICS接口提供数据 ---
-ApiFinalInfluence get_final_influence(const string& dataset_id, const string& propagation_model, const string& probability_model, const vector<int>& initial_nodes, const vector<int>& blocking_nodes) {
+ApiFinalInfluence get_final_influence(const string& dataset_id, const string& propagation_model, const string& probability_model, const vector<int>& initial_nodes, const vector<int>& blocking_nodes, const vector<Edge>& blocking_edges, const string& estimator) {
     
-    // 1. 加载图并设置模型 (与之前的逻辑相同)
-    std::string graph_filepath = "./" + dataset_id + "_subset_1000.txt";
-    InfGraph g(graph_filepath);
-    g.setInfuModel(model_str_to_enum(propagation_model));
-    g.setActiveProbabilityModel(probability_model);
+    // RR 估计器只给出期望激活节点数，不返回逐节点状态
+    if (estimator == "RR") {
+        CachedWorlds cached = get_cached_rr_pool(dataset_id, propagation_model, probability_model);
+        ApiFinalInfluence result;
+        result.result_id = "final_influence_result";
+        result.total_influence = cached.rr_pool->estimate(initial_nodes, blocking_nodes, cached.graph->edge_ids_of(blocking_edges));
+        return result;
+    }
+    if (estimator != "MC" && estimator != "PMC") {
+        throw std::invalid_argument("Unsupported estimator provided: " + estimator);
+    }
 
-    // 2. 调用【新】的、只返回最终概率的函数
-    vector<double> final_probs = g.calculate_final_probabilities(
-        initial_nodes,
-        10000, // 使用一个较高的模拟次数以保证精度
-        blocking_nodes // 【传入】
-    );
+    vector<double> final_probs;
+    if (estimator == "PMC") {
+        // 剪枝蒙特卡洛：在缩点后的 DAG 上求可达集（仅支持 IC 模型；删除边时回退到节点级 BFS）
+        CachedWorlds cached = get_cached_model(dataset_id, propagation_model, probability_model, PMC_WORLDS);
+        final_probs = cached.pmc->final_probabilities(initial_nodes, blocking_nodes, cached.graph->make_edge_mask(blocking_edges),
+                                                      cached.graph->num_threads);
+    } else {
+        // 1. 取出该数据集/模型组合缓存的图和预采样世界
+        CachedWorlds cached = get_cached_worlds(dataset_id, propagation_model, probability_model);
+        const InfGraph& g = *cached.graph;
+
+        // 2. 在固定的世界上做 BFS 求最终概率（公共随机数，交互点击之间没有蒙特卡洛抖动）
+        final_probs = cached.worlds->final_probabilities(
+            g,
+            initial_nodes,
+            blocking_nodes, // 【传入】
+            g.make_edge_mask(blocking_edges),
+            g.num_threads
+        );
+    }
     
     // 3. 将结果包装成 FinalInfluenceResult 结构体
     ApiFinalInfluence result;
@@ -230,7 +426,8 @@ ApiSimulationResult get_probability_animation(
     const string& propagation_model, 
     const string& probability_model, 
     const vector<int>& initial_nodes,
-    const vector<int>& blocking_nodes
+    const vector<int>& blocking_nodes,
+    const vector<Edge>& blocking_edges
 ) {
     // 1. 加载图并设置模型
     std::string graph_filepath = "./" + dataset_id + "_subset_1000.txt";
@@ -239,129 +436,268 @@ ApiSimulationResult get_probability_animation(
     g.setActiveProbabilityModel(probability_model);
 
     // 2. 调用 InfGraph 中我们为概率波动画设计的核心函数
-    ApiSimulationResult result = g.run_probability_simulation(initial_nodes, blocking_nodes);
+    ApiSimulationResult result = g.run_probability_simulation(initial_nodes, blocking_nodes, g.make_edge_mask(blocking_edges));
     result.result_id = generate_uuid(); // 为这次动画生成一个ID
     
     return result;
 }
 
-ApiCommunityResult run_k_core_analysis_from_scratch(
+// ================= 社区分析流水线 =================
+// 种子生成 -> 影响力最终状态 -> 社区搜索。各阶段在缓存的同一张图上进行，最终状态按 result_id 缓存，
+// 同一批种子上切换社区类型或调整 k/l 时直接复用，不再重新加载图、重新计算最终状态。
+
+// 缓存的流水线结果数，超出时淘汰最早的结果
+static const size_t MAX_CACHED_PIPELINES = 256;
+
+static std::mutex pipeline_mutex;
+static map<string, CommunityPipelineState> pipeline_cache;
+static deque<string> pipeline_order;
+
+// IMM 选出的种子按 (数据集, 传播模型, 概率模型, 预算) 缓存。IMM 会修改图（RR 集、结果集），因此在缓存图的
+// 副本上运行：副本与后续阶段使用的是同一组边概率（TR 模型的边概率在每次加载图时随机生成，重新加载会得到另一组）。
+// 缓存图发布后只读（样本构建使用缓存项中的固定种子），因此复制时无需持有缓存的锁。
+static vector<int> get_cached_imm_seeds(const string& dataset_id, const string& propagation_model, const string& probability_model,
+                                        const InfGraph& cached_graph, int seed_budget) {
+    static std::mutex imm_mutex;
+    static map<string, vector<int>> cache;
+
+    const string key = dataset_id + "|" + propagation_model + "|" + probability_model + "|" + std::to_string(seed_budget);
+    std::lock_guard<std::mutex> lock(imm_mutex);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        InfGraph g(cached_graph);
+        g.setActiveProbabilityModel(probability_model); // 让概率指针指向副本自己的数组
+        Argument arg_for_seeds;
+        arg_for_seeds.k = seed_budget;
+        arg_for_seeds.model = propagation_model;
+        arg_for_seeds.epsilon = 0.1;
+        Imm::InfluenceMaximize(g, arg_for_seeds);
+        it = cache.emplace(key, g.result_node_set).first;
+    }
+    return it->second;
+}
+
+CommunityPipelineState pipeline_generate_seeds(
     const string& dataset_id,
     const string& propagation_model,
     const string& probability_model,
-    int k_core,
     int seed_budget,
     const string& seed_generation_mode,
     const vector<int>& manual_seeds
 ) {
-    // 1. 加载图
-    std::string graph_filepath = "./" + dataset_id + "_subset_1000.txt";
-    InfGraph g(graph_filepath);
-    g.setInfuModel(model_str_to_enum(propagation_model));
-    g.setActiveProbabilityModel(probability_model);
+    CommunityPipelineState state;
+    state.dataset_id = dataset_id;
+    state.propagation_model = propagation_model;
+    state.probability_model = probability_model;
+    state.graph = get_cached_worlds(dataset_id, propagation_model, probability_model).graph;
 
-    // 2. 根据模式生成种子节点
-    vector<int> query_nodes;
     if (!manual_seeds.empty()) {
-        query_nodes = manual_seeds;
-    } else {
-        if (seed_generation_mode == "IMM") {
-            Argument arg_for_seeds;
-            arg_for_seeds.k = seed_budget;
-            arg_for_seeds.model = propagation_model;
-            arg_for_seeds.epsilon = 0.1;
-            Imm::InfluenceMaximize(g, arg_for_seeds);
-            query_nodes = g.result_node_set;
-        } else { // "RANDOM"
-            query_nodes = g.generate_random_seeds(seed_budget);
-        }
+        state.seed_nodes = manual_seeds;
+    } else if (seed_generation_mode == "IMM") {
+        state.seed_nodes = get_cached_imm_seeds(dataset_id, propagation_model, probability_model, *state.graph, seed_budget);
+    } else { // "RANDOM"
+        // 缓存的图被并发请求共享：只通过 const 接口读取，随机种子由调用内的局部随机数生成器抽取
+        state.seed_nodes = state.graph->generate_random_seeds(seed_budget);
+    }
+    return state;
+}
+
+void pipeline_compute_spread(CommunityPipelineState& state) {
+    if (!state.graph) {
+        throw std::invalid_argument("Pipeline state has no graph; call pipeline_generate_seeds first.");
+    }
+    ApiFinalInfluence influence = get_final_influence(state.dataset_id, state.propagation_model, state.probability_model, state.seed_nodes, {});
+    state.final_states = std::make_shared<const vector<NodeState>>(std::move(influence.final_states));
+    state.result_id = generate_uuid();
+
+    std::lock_guard<std::mutex> lock(pipeline_mutex);
+    pipeline_cache.emplace(state.result_id, state);
+    pipeline_order.push_back(state.result_id);
+    while (pipeline_order.size() > MAX_CACHED_PIPELINES) {
+        pipeline_cache.erase(pipeline_order.front());
+        pipeline_order.pop_front();
     }
+}
+
+CommunityPipelineState pipeline_resume(const string& result_id) {
+    std::lock_guard<std::mutex> lock(pipeline_mutex);
+    auto it = pipeline_cache.find(result_id);
+    if (it == pipeline_cache.end()) {
+        throw std::invalid_argument("Unknown or expired community result_id: " + result_id);
+    }
+    return it->second;
+}
 
-    // 3. 基于生成的种子计算影响力最终状态
-    ApiFinalInfluence influence_result = get_final_influence(dataset_id, propagation_model, probability_model, query_nodes, {});
-     if (influence_result.final_states.empty()) {
-        ApiCommunityResult result;
-        result.result_id = "from_scratch_result";
+ApiCommunityResult pipeline_search_community(const CommunityPipelineState& state, const string& community_type, int k, int l) {
+    if (!state.final_states) {
+        throw std::invalid_argument("Pipeline state has no final states; call pipeline_compute_spread first.");
+    }
+    ApiCommunityResult result;
+    result.result_id = state.result_id;
+    result.seed_nodes = state.seed_nodes;
+    if (state.final_states->empty()) {
         result.message = "Generated seeds did not result in any influence, cannot perform community analysis.";
         return result;
     }
 
-    // 4. 调用核心的社区发现算法
-    CommunityResult community = CommunitySearcher::find_k_core_community(k_core, influence_result.final_states, g, query_nodes);
+    const vector<NodeState>& final_states = *state.final_states;
+    const InfGraph& g = *state.graph;
+    string condition;
+    if (community_type == "KL_CORE") {
+        CachedStructure structure = get_cached_structure(state.dataset_id, g, DCORE_INDEX);
+        result.community = CommunitySearcher::find_most_influenced_community_local(k, l, final_states, g, state.seed_nodes, structure.dcore.get());
+        condition = "(" + std::to_string(k) + "," + std::to_string(l) + ")-core";
+    } else if (community_type == "K_CORE") {
+        CachedStructure structure = get_cached_structure(state.dataset_id, g, CORE_INDEX);
+        result.community = CommunitySearcher::find_k_core_community(k, final_states, g, state.seed_nodes, structure.core.get());
+        condition = std::to_string(k) + "-core";
+    } else if (community_type == "K_TRUSS") {
+        CachedStructure structure = get_cached_structure(state.dataset_id, g, TRUSS_INDEX);
+        result.community = CommunitySearcher::find_k_truss_community(k, final_states, g, state.seed_nodes, structure.truss.get());
+        condition = std::to_string(k) + "-truss";
+    } else if (community_type == "K_CORE_INFLUENCE") {
+        CachedStructure structure = get_cached_structure(state.dataset_id, g, CORE_INDEX);
+        result.community = CommunitySearcher::find_influential_k_core_community(k, final_states, g, state.seed_nodes, structure.core.get());
+        condition = std::to_string(k) + "-core";
+    } else if (community_type == "K_TRUSS_INFLUENCE") {
+        CachedStructure structure = get_cached_structure(state.dataset_id, g, TRUSS_INDEX);
+        result.community = CommunitySearcher::find_influential_k_truss_community(k, final_states, g, state.seed_nodes, structure.truss.get());
+        condition = std::to_string(k) + "-truss";
+    } else {
+        throw std::invalid_argument("Unsupported community type provided: " + community_type);
+    }
+    result.final_states = final_states; // 【核心修改】将影响力状态存入结果
+
+    if (community_type == "K_CORE_INFLUENCE" || community_type == "K_TRUSS_INFLUENCE") {
+        if (result.community.node_count > 0) {
+            result.message = "Found the connected " + condition + " community with the highest average influence probability (" +
+                             std::to_string(result.community.average_influence_prob) + ", " + std::to_string(result.community.node_count) + " nodes).";
+        } else {
+            result.message = "No undirected community satisfying the " + condition + " condition was found for the generated seeds.";
+        }
+    } else if (community_type == "KL_CORE") {
+        if (result.community.node_count > 0) {
+            result.message = "Found a community that satisfies the " + condition +
+                             " condition with an average influence probability of " + std::to_string(result.community.average_influence_prob) + ".";
+        } else {
+            result.message = "No community satisfying the " + condition + " condition was found for the generated seeds.";
+        }
+    } else {
+        if (result.community.node_count > 0) {
+            result.message = "Found an undirected community that satisfies the " + condition + " condition.";
+        } else {
+            result.message = "No undirected community satisfying the " + condition + " condition was found for the generated seeds.";
+        }
+    }
+    return result;
+}
 
-    // 5. 封装返回结果
-    ApiCommunityResult result;
-    result.result_id = "from_scratch_result";
-    result.community = community;
-    result.final_states = influence_result.final_states; // 【核心修改】将影响力状态存入结果
-    result.seed_nodes = query_nodes;
-    if (community.node_count > 0) {
-        result.message = "Found an undirected community that satisfies the " + std::to_string(k_core) + "-core condition.";
+ApiBatchCommunityResult pipeline_search_communities_batch(const CommunityPipelineState& state, const string& community_type, int k, int l,
+                                                           const vector<int>& query_nodes) {
+    if (!state.final_states) {
+        throw std::invalid_argument("Pipeline state has no final states; call pipeline_compute_spread first.");
+    }
+    const vector<int>& queries = query_nodes.empty() ? state.seed_nodes : query_nodes;
+    const vector<NodeState>& final_states = *state.final_states;
+    const InfGraph& g = *state.graph;
+
+    ApiBatchCommunityResult result;
+    result.result_id = state.result_id;
+    result.seed_nodes = state.seed_nodes;
+    string condition;
+    if (community_type == "KL_CORE") {
+        CachedStructure structure = get_cached_structure(state.dataset_id, g, DCORE_INDEX);
+        result.batch = CommunitySearcher::find_kl_core_communities_batch(k, l, final_states, g, queries, structure.dcore.get());
+        condition = "(" + std::to_string(k) + "," + std::to_string(l) + ")-core";
+    } else if (community_type == "K_CORE") {
+        CachedStructure structure = get_cached_structure(state.dataset_id, g, CORE_INDEX);
+        result.batch = CommunitySearcher::find_k_core_communities_batch(k, final_states, g, queries, structure.core.get());
+        condition = std::to_string(k) + "-core";
+    } else if (community_type == "K_TRUSS") {
+        CachedStructure structure = get_cached_structure(state.dataset_id, g, TRUSS_INDEX);
+        result.batch = CommunitySearcher::find_k_truss_communities_batch(k, final_states, g, queries, structure.truss.get());
+        condition = std::to_string(k) + "-truss";
     } else {
-        result.message = "No undirected community satisfying the " + std::to_string(k_core) + "-core condition was found for the generated seeds.";
+        throw std::invalid_argument("Unsupported community type provided: " + community_type);
     }
+    result.final_states = final_states;
+
+    int covered = 0;
+    for (int c : result.batch.community_of_query) {
+        if (c >= 0) covered++;
+    }
+    result.message = "Found " + std::to_string(result.batch.communities.size()) + " distinct communities satisfying the " + condition +
+                     " condition, covering " + std::to_string(covered) + " of " + std::to_string(queries.size()) + " query nodes.";
     return result;
 }
 
-ApiCommunityResult run_kl_core_analysis_from_scratch(
+// “从零开始”的入口共用的前两个阶段：给出 result_id 时复用缓存的种子与最终状态（模型需一致），否则依次运行
+static CommunityPipelineState prepare_community_pipeline(
     const string& dataset_id,
     const string& propagation_model,
     const string& probability_model,
-    int k_core,
-    int l_core,
     int seed_budget,
     const string& seed_generation_mode,
-    const vector<int>& manual_seeds
+    const vector<int>& manual_seeds,
+    const string& result_id
 ) {
-    // 1. 加载图
-    std::string graph_filepath = "./" + dataset_id + "_subset_1000.txt";
-    InfGraph g(graph_filepath);
-    g.setInfuModel(model_str_to_enum(propagation_model));
-    g.setActiveProbabilityModel(probability_model);
-
-    // 2. 根据模式生成种子节点
-    vector<int> query_nodes;
-    if (!manual_seeds.empty()) {
-        query_nodes = manual_seeds;
-    } else {
-        if (seed_generation_mode == "IMM") {
-            Argument arg_for_seeds;
-            arg_for_seeds.k = seed_budget;
-            arg_for_seeds.model = propagation_model;
-            arg_for_seeds.epsilon = 0.1;
-            Imm::InfluenceMaximize(g, arg_for_seeds);
-            query_nodes = g.result_node_set;
-        } else { // "RANDOM"
-            query_nodes = g.generate_random_seeds(seed_budget);
+    CommunityPipelineState state;
+    if (!result_id.empty()) {
+        state = pipeline_resume(result_id);
+        if (state.dataset_id != dataset_id || state.propagation_model != propagation_model || state.probability_model != probability_model) {
+            throw std::invalid_argument("result_id " + result_id + " was computed for a different dataset or model.");
         }
+    } else {
+        state = pipeline_generate_seeds(dataset_id, propagation_model, probability_model, seed_budget, seed_generation_mode, manual_seeds);
+        pipeline_compute_spread(state);
     }
+    return state;
+}
 
-    // 3. 基于生成的种子计算影响力最终状态
-    ApiFinalInfluence influence_result = get_final_influence(dataset_id, propagation_model, probability_model, query_nodes, {});
-    if (influence_result.final_states.empty()) {
-        ApiCommunityResult result;
-        result.result_id = "from_scratch_result";
-        result.message = "Generated seeds did not result in any influence, cannot perform community analysis.";
-        return result;
-    }
-
-    // 4. 调用核心的社区发现算法
-    CommunityResult community = CommunitySearcher::find_most_influenced_community_local(k_core, l_core, influence_result.final_states, g, query_nodes);
+static ApiCommunityResult run_community_pipeline(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    const string& community_type,
+    int k,
+    int l,
+    int seed_budget,
+    const string& seed_generation_mode,
+    const vector<int>& manual_seeds,
+    const string& result_id
+) {
+    CommunityPipelineState state = prepare_community_pipeline(dataset_id, propagation_model, probability_model,
+                                                              seed_budget, seed_generation_mode, manual_seeds, result_id);
+    return pipeline_search_community(state, community_type, k, l);
+}
 
-    // 5. 封装返回结果
-    ApiCommunityResult result;
-    result.result_id = "from_scratch_result";
-    result.community = community;
-    result.final_states = influence_result.final_states; // 【核心修改】将影响力状态存入结果
-    result.seed_nodes = query_nodes;
-    if (community.node_count > 0) {
-        result.message = "Found a community that satisfies the (" + std::to_string(k_core) + "," + std::to_string(l_core) +
-                         ")-core condition with an average influence probability of " + std::to_string(community.average_influence_prob) + ".";
-    } else {
-        result.message = "No community satisfying the (" + std::to_string(k_core) + "," + std::to_string(l_core) + ")-core condition was found for the generated seeds.";
-    }
+ApiCommunityResult run_k_core_analysis_from_scratch(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    int k_core,
+    int seed_budget,
+    const string& seed_generation_mode,
+    const vector<int>& manual_seeds,
+    const string& result_id
+) {
+    return run_community_pipeline(dataset_id, propagation_model, probability_model, "K_CORE", k_core, 0,
+                                  seed_budget, seed_generation_mode, manual_seeds, result_id);
+}
 
-    return result;
+ApiCommunityResult run_kl_core_analysis_from_scratch(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    int k_core,
+    int l_core,
+    int seed_budget,
+    const string& seed_generation_mode,
+    const vector<int>& manual_seeds,
+    const string& result_id
+) {
+    return run_community_pipeline(dataset_id, propagation_model, probability_model, "KL_CORE", k_core, l_core,
+                                  seed_budget, seed_generation_mode, manual_seeds, result_id);
 }
 
 // 【【【新增】】】实现可以“从零开始”的 k-truss 社区分析函数
@@ -372,65 +708,55 @@ ApiCommunityResult run_k_truss_analysis_from_scratch(
     int k_truss,
     int seed_budget,
     const string& seed_generation_mode,
-    const vector<int>& manual_seeds
+    const vector<int>& manual_seeds,
+    const string& result_id
 ) {
-    // 1. 加载图
-    std::string graph_filepath = "./" + dataset_id + "_subset_1000.txt";
-    InfGraph g(graph_filepath);
-    g.setInfuModel(model_str_to_enum(propagation_model));
-    g.setActiveProbabilityModel(probability_model);
-
-    // 2. 根据模式生成种子节点
-    vector<int> query_nodes;
-    if (!manual_seeds.empty()) {
-        query_nodes = manual_seeds;
-    } else {
-        if (seed_generation_mode == "IMM") {
-            Argument arg_for_seeds;
-            arg_for_seeds.k = seed_budget;
-            arg_for_seeds.model = propagation_model;
-            arg_for_seeds.epsilon = 0.1;
-            Imm::InfluenceMaximize(g, arg_for_seeds);
-            query_nodes = g.result_node_set;
-        } else { // "RANDOM"
-            query_nodes = g.generate_random_seeds(seed_budget);
-        }
-    }
-
-    ApiFinalInfluence influence_result = get_final_influence(dataset_id, propagation_model, probability_model, query_nodes, {});
-
-    // 3. 基于生成的种子计算影响力最终状态
-    if (influence_result.final_states.empty()) {
-        ApiCommunityResult result;
-        result.result_id = "from_scratch_result";
-        result.message = "Generated seeds did not result in any influence, cannot perform community analysis.";
-        
-        return result;
+    return run_community_pipeline(dataset_id, propagation_model, probability_model, "K_TRUSS", k_truss, 0,
+                                  seed_budget, seed_generation_mode, manual_seeds, result_id);
+}
+ApiCommunityResult run_influential_community_analysis_from_scratch(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    const string& constraint_type,
+    int k,
+    int seed_budget,
+    const string& seed_generation_mode,
+    const vector<int>& manual_seeds,
+    const string& result_id
+) {
+    if (constraint_type != "K_CORE" && constraint_type != "K_TRUSS") {
+        throw std::invalid_argument("Unsupported community constraint provided: " + constraint_type);
     }
+    return run_community_pipeline(dataset_id, propagation_model, probability_model, constraint_type + "_INFLUENCE", k, 0,
+                                  seed_budget, seed_generation_mode, manual_seeds, result_id);
+}
 
-    // 4. 调用核心的社区发现算法
-    CommunityResult community = CommunitySearcher::find_k_truss_community(k_truss, influence_result.final_states, g, query_nodes);
-
-    // 5. 封装返回结果
-    ApiCommunityResult result;
-    result.result_id = "from_scratch_result";
-    result.community = community;
-    result.final_states = influence_result.final_states; // 【核心修改】将影响力状态存入结果
-    result.seed_nodes = query_nodes;
-    if (community.node_count > 0) {
-        result.message = "Found an undirected community that satisfies the " + std::to_string(k_truss) + "-truss condition.";
-    } else {
-        result.message = "No undirected community satisfying the " + std::to_string(k_truss) + "-truss condition was found for the generated seeds.";
-    }
-    return result;
+ApiBatchCommunityResult run_community_batch_analysis_from_scratch(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    const string& community_type,
+    int k,
+    int l,
+    int seed_budget,
+    const string& seed_generation_mode,
+    const vector<int>& manual_seeds,
+    const string& result_id
+) {
+    CommunityPipelineState state = prepare_community_pipeline(dataset_id, propagation_model, probability_model,
+                                                              seed_budget, seed_generation_mode, manual_seeds, result_id);
+    return pipeline_search_communities_batch(state, community_type, k, l);
 }
+
 // 【最终修正】替换 influence_calculator.cpp 中的 get_blocking_animation 函数
 ApiSimulationResult get_blocking_animation(
     const string& dataset_id,
     const string& propagation_model,
     const string& probability_model,
     const vector<int>& initial_nodes,
-    const vector<int>& blocking_nodes
+    const vector<int>& blocking_nodes,
+    const vector<Edge>& blocking_edges
 ) {
     ApiSimulationResult result;
     result.result_id = generate_uuid();
@@ -441,10 +767,14 @@ ApiSimulationResult get_blocking_animation(
     g.setInfuModel(model_str_to_enum(propagation_model));
     g.setActiveProbabilityModel(probability_model);
 
-    // 2. Step 0: 计算完全阻塞前的状态
+    // 2. 一次性采样固定的活跃边样本，所有阻塞前缀共用（公共随机数），逐个阻塞时增量更新
+    const int NUM_LIVE_EDGE_SAMPLES = 5000;
+    IncrementalBlockingEvaluator evaluator(g, initial_nodes, NUM_LIVE_EDGE_SAMPLES);
+
+    // Step 0: 计算完全阻塞前的状态
     SimulationStep step0;
     step0.step = 0;
-    vector<double> probs_before = g.calculate_final_probabilities(initial_nodes, 10000, {});
+    const vector<double>& probs_before = evaluator.probabilities();
     set<int> previously_active_ids;
     for(size_t i = 0; i < probs_before.size(); ++i) {
         if (probs_before[i] > 0.5) {
@@ -459,12 +789,20 @@ ApiSimulationResult get_blocking_animation(
     // --- 【核心修正】新增一个集合，用于记录所有已经被拯救过的节点 ---
     set<int> all_recovered_ids;
 
-    // 3. 逐个添加阻塞节点，生成后续步骤
-    for (size_t i = 0; i < blocking_nodes.size(); ++i) {
+    // 3. 逐个添加阻塞节点，再逐条删除阻塞边（同一对节点间的重边在同一步删除），生成后续步骤
+    const size_t num_steps = blocking_nodes.size() + blocking_edges.size();
+    for (size_t i = 0; i < num_steps; ++i) {
         SimulationStep current_step;
         current_step.step = i + 1;
-        vector<int> current_blocking_subset(blocking_nodes.begin(), blocking_nodes.begin() + i + 1);
-        vector<double> current_probs = g.calculate_final_probabilities(initial_nodes, 10000, current_blocking_subset);
+        if (i < blocking_nodes.size()) {
+            evaluator.block(blocking_nodes[i]);
+        } else {
+            const vector<char> mask = g.make_edge_mask({blocking_edges[i - blocking_nodes.size()]});
+            for (size_t eid = 0; eid < mask.size(); ++eid) {
+                if (mask[eid]) evaluator.block_edge(eid);
+            }
+        }
+        const vector<double>& current_probs = evaluator.probabilities();
         
         set<int> current_active_ids;
         for(size_t j = 0; j < current_probs.size(); ++j) {
@@ -498,75 +836,128 @@ ApiSimulationResult get_blocking_animation(
 
 // 【新增】将这个完整的函数粘贴到 influence_calculator.cpp 中
 
-// 辅助函数：递归计算节点的深度（复用之前的版本）
-int get_node_depth_for_critical_path(int node, const map<int, int>& parent_map, map<int, int>& memo) {
-    if (memo.count(node)) return memo[node];
-    if (!parent_map.count(node) || parent_map.at(node) == -1) {
-        memo[node] = 0;
-        return 0;
-    }
-    int parent = parent_map.at(node);
-    int depth = 1 + get_node_depth_for_critical_path(parent, parent_map, memo);
-    memo[node] = depth;
-    return depth;
-}
-
 ApiCriticalPathResult find_critical_paths(
     const string& result_id,
     const string& dataset_id,
     const string& propagation_model,
     const string& probability_model,
-    const vector<int>& initial_nodes
+    const vector<int>& initial_nodes,
+    int top_k
 ) {
     ApiCriticalPathResult result;
     result.result_id = result_id;
+    result.num_samples = 0;
+    result.mean_depth = 0.0;
 
-    // 1. 加载图并设置模型
-    std::string graph_filepath = "./" + dataset_id + "_subset_1000.txt";
-    InfGraph g(graph_filepath);
-    g.setInfuModel(model_str_to_enum(propagation_model));
-    g.setActiveProbabilityModel(probability_model);
+    // 1. 取出缓存的图和预采样世界（与最终状态使用同一批世界）
+    CachedWorlds cached = get_cached_worlds(dataset_id, propagation_model, probability_model);
+    const InfGraph& g = *cached.graph;
 
-    // 2. 运行一次模拟以获取传播树
-    map<int, int> parent_map = g.run_forward_simulation_with_parent_tracking(initial_nodes, {});
-    if (parent_map.empty()) {
+    // 2. 在全部世界上追踪传播树，汇总激活边次数和传播深度
+    CascadeStatistics stats = collect_cascade_statistics(*cached.worlds, g, initial_nodes, {}, {}, g.num_threads);
+    result.num_samples = stats.num_samples;
+    if (stats.depth_count.empty()) {
         result.message = "模拟未产生任何激活节点，无法找到路径。";
         return result;
     }
-    
-    // 3. 找到最深的节点
-    map<int, int> depth_memo;
-    int max_depth = -1;
-    int deepest_node = -1;
-
-    for (auto const& [child, parent] : parent_map) {
-        int depth = get_node_depth_for_critical_path(child, parent_map, depth_memo);
-        if (depth > max_depth) {
-            max_depth = depth;
-            deepest_node = child;
-        }
+    for (size_t d = 0; d < stats.depth_count.size(); ++d) {
+        double share = static_cast<double>(stats.depth_count[d]) / stats.num_samples;
+        result.depth_distribution.push_back(share);
+        result.mean_depth += share * d;
     }
 
-    if (deepest_node == -1) {
+    // 3. 经验概率最大的传播路径，以及出现过的最深路径
+    PropagationPath deepest;
+    vector<PropagationPath> paths = most_probable_paths(*cached.worlds, g, initial_nodes, stats, top_k, &deepest, g.num_threads);
+    if (deepest.nodes.empty()) {
         result.message = "未能确定最深路径。";
         return result;
     }
 
-    // 4. 从最深的节点回溯以构建路径
-    CriticalPath path;
-    path.type = "deepest";
-    path.score = max_depth;
-    vector<int> node_sequence;
-    int current_node = deepest_node;
-    while (current_node != -1) {
-        node_sequence.push_back(current_node);
-        if (!parent_map.count(current_node)) break; // 安全检查
-        current_node = parent_map.at(current_node);
+    CriticalPath deepest_path;
+    deepest_path.type = "deepest";
+    deepest_path.nodes = deepest.nodes;
+    deepest_path.score = deepest.nodes.size() - 1;
+    deepest_path.probability = static_cast<double>(deepest.count) / stats.num_samples;
+    result.critical_paths.push_back(deepest_path);
+    for (const PropagationPath& p : paths) {
+        CriticalPath path;
+        path.type = "most_probable";
+        path.nodes = p.nodes;
+        path.probability = static_cast<double>(p.count) / stats.num_samples;
+        path.score = path.probability;
+        result.critical_paths.push_back(path);
     }
-    std::reverse(node_sequence.begin(), node_sequence.end()); // 反转为从种子到末端的顺序
-    path.nodes = node_sequence;
-    
-    result.critical_paths.push_back(path);
-    result.message = "Successfully found a deepest propagation path with length " + std::to_string(max_depth) + ".";
+
+    result.message = "Analyzed " + std::to_string(stats.num_samples) + " sampled cascades (mean depth " + std::to_string(result.mean_depth)
+                   + "). Deepest recurring path has length " + std::to_string(deepest.nodes.size() - 1)
+                   + "; found " + std::to_string(paths.size()) + " most probable propagation paths.";
     return result;
-}
\ No newline at end of file
+}
+
+ApiBatchSpreadResult evaluate_spread_batch(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    const vector<SpreadQuery>& queries,
+    bool include_states,
+    const string& estimator
+) {
+    if (estimator != "MC" && estimator != "RR" && estimator != "PMC") {
+        throw std::invalid_argument("Unsupported estimator provided: " + estimator);
+    }
+    const bool use_rr = (estimator == "RR");
+    const bool use_pmc = (estimator == "PMC");
+
+    // 1. 所有查询共享缓存的图和预采样世界（或 RR 集池、缩点世界），不再逐个加载图、重新模拟
+    CachedWorlds cached = use_rr ? get_cached_rr_pool(dataset_id, propagation_model, probability_model)
+                        : use_pmc ? get_cached_model(dataset_id, propagation_model, probability_model, PMC_WORLDS)
+                                  : get_cached_worlds(dataset_id, propagation_model, probability_model);
+    const InfGraph& g = *cached.graph;
+    const double threshold = 0.5;
+
+    ApiBatchSpreadResult result;
+    result.result_id = generate_uuid();
+    result.num_worlds = use_rr ? 0 : (use_pmc ? cached.pmc->size() : cached.worlds->size());
+    result.results.resize(queries.size());
+
+    // 2. 查询之间并行，每个查询内部单线程遍历全部世界
+    parallel_for(queries.size(), g.num_threads, [&](int, int64_t begin, int64_t end) {
+        for (int64_t q = begin; q < end; ++q) {
+            if (use_rr) {
+                // RR 估计器只给出期望激活节点数
+                result.results[q].total_influence = cached.rr_pool->estimate(queries[q].seed_nodes, queries[q].blocking_nodes,
+                                                                             g.edge_ids_of(queries[q].blocking_edges));
+                result.results[q].active_count = -1;
+                continue;
+            }
+            if (use_pmc && !include_states) {
+                // 只需要总量时直接在 DAG 上累加分量权重
+                result.results[q].total_influence = cached.pmc->spread(queries[q].seed_nodes, queries[q].blocking_nodes,
+                                                                       g.make_edge_mask(queries[q].blocking_edges));
+                result.results[q].active_count = -1;
+                continue;
+            }
+            const vector<char> edge_mask = g.make_edge_mask(queries[q].blocking_edges);
+            vector<double> probs = use_pmc ? cached.pmc->final_probabilities(queries[q].seed_nodes, queries[q].blocking_nodes, edge_mask)
+                                           : cached.worlds->final_probabilities(g, queries[q].seed_nodes, queries[q].blocking_nodes, edge_mask, 1);
+            SpreadQueryResult& out = result.results[q];
+            out.total_influence = 0.0;
+            out.active_count = 0;
+            for (int v = 0; v < g.n; ++v) {
+                if (probs[v] <= 1e-6) continue;
+                out.total_influence += probs[v];
+                if (probs[v] >= threshold) out.active_count++;
+                if (include_states) {
+                    out.final_states.push_back({v, probs[v] >= threshold ? "active" : "inactive", probs[v]});
+                }
+            }
+        }
+    });
+
+    result.message = "Evaluated " + std::to_string(queries.size()) + " seed/blocker sets on "
+                   + (use_rr ? std::to_string(cached.rr_pool->size()) + " shared RR sets."
+                    : use_pmc ? std::to_string(result.num_worlds) + " shared condensed worlds."
+                             : std::to_string(result.num_worlds) + " shared sampled worlds.");
+    return result;
+}
@@ -2,6 +2,12 @@
 #define INFLUENCE_CALCULATOR_H
 
 #include "community.h"
+#include "live_edge.h"
+#include "dominator.h"
+#include "world_store.h"
+#include "rr_estimator.h"
+#include "pmc.h"
+#include "cascade_paths.h"
 // 声明核心计算函数，它接收一个API请求结构体，并返回一个API结果结构体
 ApiResult run_influence_maximization(const ApiRequest& request);
 
@@ -12,7 +18,9 @@ ApiFinalInfluence get_final_influence(
     const string& propagation_model, 
     const string& probability_model, 
     const vector<int>& initial_nodes,
-    const vector<int>& blocking_nodes // 【新增】
+    const vector<int>& blocking_nodes, // 【新增】
+    const vector<Edge>& blocking_edges = {}, // 边阻塞模式下被删除的边
+    const string& estimator = "MC" // "MC": 预采样世界上的逐节点概率；"RR": 只估计期望激活节点数；"PMC": 缩点世界上的逐节点概率（仅 IC）
 );
 
 // 【新增】声明用于获取概率波动画数据的函数
@@ -21,7 +29,56 @@ ApiSimulationResult get_probability_animation(
     const string& propagation_model, 
     const string& probability_model, 
     const vector<int>& initial_nodes,
-    const vector<int>& blocking_nodes // 新增阻塞节点参数
+    const vector<int>& blocking_nodes, // 新增阻塞节点参数
+    const vector<Edge>& blocking_edges = {}
+);
+
+// 社区分析流水线：种子生成 -> 影响力最终状态 -> 社区搜索。
+// 各阶段之间传递同一张缓存图、种子和最终状态；最终状态按 result_id 缓存，
+// 同一批种子上切换社区类型或调整 k/l 时直接复用，不再重新加载图和计算最终状态。
+struct CommunityPipelineState {
+    string result_id; // pipeline_compute_spread 之后有效
+    string dataset_id;
+    string propagation_model;
+    string probability_model;
+    shared_ptr<const InfGraph> graph; // 该数据集/模型组合缓存的图（多个请求共享，只读）
+    vector<int> seed_nodes;
+    shared_ptr<const vector<NodeState>> final_states;
+};
+
+// 阶段一：取出缓存的图并确定种子（手动种子优先；"IMM" 的结果按预算缓存；否则随机）
+CommunityPipelineState pipeline_generate_seeds(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    int seed_budget,
+    const string& seed_generation_mode,
+    const vector<int>& manual_seeds
+);
+
+// 阶段二：在缓存的预采样世界上计算最终状态，分配 result_id 并缓存
+void pipeline_compute_spread(CommunityPipelineState& state);
+
+// 按 result_id 取回缓存的流水线状态；不存在（或已被淘汰）时抛出 std::invalid_argument
+CommunityPipelineState pipeline_resume(const string& result_id);
+
+// 阶段三：community_type 为 "KL_CORE"（使用 k、l）、"K_CORE" 或 "K_TRUSS"（只使用 k）；
+// "K_CORE_INFLUENCE" / "K_TRUSS_INFLUENCE" 在对应约束下查找平均影响概率最大的连通社区
+ApiCommunityResult pipeline_search_community(
+    const CommunityPipelineState& state,
+    const string& community_type,
+    int k,
+    int l = 0
+);
+
+// 批量模式：对 query_nodes（为空时取全部种子）只做一次剥离，返回每个查询节点所在的社区（相同的社区只保存一次）。
+// community_type 为 "KL_CORE"、"K_CORE" 或 "K_TRUSS"
+ApiBatchCommunityResult pipeline_search_communities_batch(
+    const CommunityPipelineState& state,
+    const string& community_type,
+    int k,
+    int l = 0,
+    const vector<int>& query_nodes = {}
 );
 
 // 【【【新增】】】声明可以“从零开始”的 (k,l)-core 社区分析函数
@@ -33,7 +90,8 @@ ApiCommunityResult run_kl_core_analysis_from_scratch(
     int l_core,
     int seed_budget,
     const string& seed_generation_mode,
-    const vector<int>& manual_seeds // 允许用户手动输入种子
+    const vector<int>& manual_seeds, // 允许用户手动输入种子
+    const string& result_id = "" // 非空时复用该结果缓存的种子与最终状态（忽略种子相关参数）
 );
 
 
@@ -47,7 +105,8 @@ ApiCommunityResult run_k_core_analysis_from_scratch(
     int k_core,
     int seed_budget,
     const string& seed_generation_mode,
-    const vector<int>& manual_seeds
+    const vector<int>& manual_seeds,
+    const string& result_id = ""
 );
 
 
@@ -59,7 +118,37 @@ ApiCommunityResult run_k_truss_analysis_from_scratch(
     int k_truss,
     int seed_budget,
     const string& seed_generation_mode,
-    const vector<int>& manual_seeds
+    const vector<int>& manual_seeds,
+    const string& result_id = ""
+);
+
+
+// 在 k-core（constraint_type = "K_CORE"）或 k-truss（"K_TRUSS"）约束下，查找包含种子的、平均影响概率最大的连通社区
+ApiCommunityResult run_influential_community_analysis_from_scratch(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    const string& constraint_type,
+    int k,
+    int seed_budget,
+    const string& seed_generation_mode,
+    const vector<int>& manual_seeds,
+    const string& result_id = ""
+);
+
+
+// 以全部种子为查询节点的批量社区分析（community_type 同 pipeline_search_communities_batch）
+ApiBatchCommunityResult run_community_batch_analysis_from_scratch(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    const string& community_type,
+    int k,
+    int l,
+    int seed_budget,
+    const string& seed_generation_mode,
+    const vector<int>& manual_seeds,
+    const string& result_id = ""
 );
 
 
@@ -71,16 +160,32 @@ ApiSimulationResult get_blocking_animation(
     const string& propagation_model,
     const string& probability_model,
     const vector<int>& initial_nodes,
-    const vector<int>& blocking_nodes
+    const vector<int>& blocking_nodes,
+    const vector<Edge>& blocking_edges = {} // 边阻塞模式下逐条删除的边，排在阻塞节点之后
 );
 
 // 【添加】将这个新函数声明添加到 influence_calculator.h 中
+// 在缓存的预采样世界上统计传播树：返回出现过的最深路径、经验概率最大的 top_k 条传播路径以及传播深度分布
 ApiCriticalPathResult find_critical_paths(
     const string& result_id,
     const string& dataset_id,
     const string& propagation_model,
     const string& probability_model,
-    const vector<int>& initial_nodes
+    const vector<int>& initial_nodes,
+    int top_k = 5
+);
+
+// 批量评估多个 (种子, 阻塞) 组合的影响力：所有查询共享同一张图和同一批预采样世界，并行求值。
+// include_states 为真时额外返回每个查询的逐节点激活概率。
+// estimator 为 "RR" 时改用缓存的 RR 集池，只返回期望激活节点数（active_count 为 -1）；
+// 为 "PMC" 时改用缩点后的 IC 世界（不需要逐节点概率时同样只返回期望激活节点数）。
+ApiBatchSpreadResult evaluate_spread_batch(
+    const string& dataset_id,
+    const string& propagation_model,
+    const string& probability_model,
+    const vector<SpreadQuery>& queries,
+    bool include_states = false,
+    const string& estimator = "MC"
 );
 
 #endif // INFLUENCE_CALCULATOR_H
@@ -0,0 +1,351 @@
+#ifndef INFLUENCE_PEEL_H
+#define INFLUENCE_PEEL_H
+
+#include "local_graph.h"
+#include <queue>
+#include <functional>
+
+// 影响力加权的贪心剥离：在包含查询节点（锚点）、满足最小核数（或 truss）约束的连通社区中最大化平均影响概率。
+// 从包含锚点的连通 k-core（k-truss）出发，用按概率排序的最小堆反复取出概率最低的节点尝试删除，
+// 删除引起的度数（支持度）不足按增量方式连锁剥离；连锁会删除锚点时回滚并把该节点固定下来——
+// 子图只会越来越小，连锁范围只会越来越大，之后再删除它同样不安全，因此每个节点最多被回滚一次。
+// 每次成功删除后剩余节点仍满足约束。剥离结束后把各批删除倒序加回，用并查集维护包含锚点的连通分量的
+// 概率和与节点数，取平均概率最大的状态（相同时取更大的社区）。除回滚外 k-core 版本为 O(m log n)，
+// k-truss 版本的三角形枚举为 O(m^1.5)。
+
+namespace influence_peel_detail
+{
+    // 倒序加回时使用的并查集：根节点上维护分量的概率和、节点数与锚点数
+    struct ComponentSets
+    {
+        vector<int> parent, count, anchors;
+        vector<double> sum;
+
+        explicit ComponentSets(int n) : parent(n), count(n, 0), anchors(n, 0), sum(n, 0.0)
+        {
+            for (int v = 0; v < n; ++v)
+                parent[v] = v;
+        }
+
+        int find(int x)
+        {
+            while (parent[x] != x)
+            {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        }
+
+        void add(int v, double p, bool anchor)
+        {
+            count[v] = 1;
+            sum[v] = p;
+            anchors[v] = anchor ? 1 : 0;
+        }
+
+        void unite(int a, int b)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return;
+            if (count[a] < count[b])
+                std::swap(a, b);
+            parent[b] = a;
+            count[a] += count[b];
+            sum[a] += sum[b];
+            anchors[a] += anchors[b];
+        }
+    };
+
+    // 所有锚点连通时返回它们所在分量的平均概率，否则返回 -1
+    inline double anchored_average(ComponentSets &sets, const vector<int> &anchors)
+    {
+        int r = sets.find(anchors[0]);
+        if (sets.anchors[r] != (int)anchors.size())
+            return -1.0;
+        return sets.sum[r] / sets.count[r];
+    }
+
+    // 按批次倒序加回，返回平均概率最大的状态下仍被删除的批次数。
+    // add_batch(b) 加回第 b 批并在 sets 中合并；初始时 sets 已包含剥离结束时的剩余图。
+    template <typename AddBatch>
+    inline int best_state(ComponentSets &sets, const vector<int> &anchors, int num_batches, AddBatch add_batch)
+    {
+        int best = num_batches;
+        double best_avg = anchored_average(sets, anchors);
+        for (int b = num_batches - 1; b >= 0; --b)
+        {
+            add_batch(b);
+            double avg = anchored_average(sets, anchors);
+            if (avg >= 0 && avg >= best_avg - 1e-12)
+            {
+                best_avg = avg;
+                best = b;
+            }
+        }
+        return best;
+    }
+
+    typedef std::pair<double, int> HeapEntry;
+    typedef std::priority_queue<HeapEntry, vector<HeapEntry>, std::greater<HeapEntry>> MinHeap;
+}
+
+// k-core 约束：initial 为初始社区（包含锚点的连通 k-core）的节点标记，prob 为局部ID -> 影响概率。
+// 返回平均概率最大的、包含全部锚点的连通 k-core（局部ID）。
+inline vector<int> peel_max_average_core(const LocalGraph &lg, const vector<double> &prob, const vector<char> &initial,
+                                         int k, const vector<int> &anchors)
+{
+    using namespace influence_peel_detail;
+    const int n = lg.size();
+    if (anchors.empty())
+        return {};
+    vector<char> alive(initial), fixed(n, 0), is_anchor(n, 0);
+    vector<int> deg(n, 0);
+    for (int a : anchors)
+        fixed[a] = is_anchor[a] = 1;
+    MinHeap heap;
+    for (int v = 0; v < n; ++v)
+    {
+        if (!alive[v])
+            continue;
+        for (int e = lg.und_offset[v]; e < lg.und_offset[v + 1]; ++e)
+            deg[v] += alive[lg.und_adj[e]];
+        if (!fixed[v])
+            heap.push({prob[v], v});
+    }
+
+    // removed 按删除顺序记录节点，batch_end[b] 为第 b 批删除结束时 removed 的长度
+    vector<int> removed, batch_end, stack, touched;
+    while (!heap.empty())
+    {
+        int v = heap.top().second;
+        heap.pop();
+        if (!alive[v] || fixed[v])
+            continue;
+
+        const size_t first = removed.size();
+        bool safe = true;
+        touched.clear();
+        alive[v] = 0;
+        removed.push_back(v);
+        stack.push_back(v);
+        while (!stack.empty() && safe)
+        {
+            int u = stack.back();
+            stack.pop_back();
+            for (int e = lg.und_offset[u]; e < lg.und_offset[u + 1]; ++e)
+            {
+                int w = lg.und_adj[e];
+                if (!alive[w])
+                    continue;
+                touched.push_back(w);
+                if (--deg[w] < k)
+                {
+                    if (fixed[w])
+                    {
+                        safe = false;
+                        break;
+                    }
+                    alive[w] = 0;
+                    removed.push_back(w);
+                    stack.push_back(w);
+                }
+            }
+        }
+        stack.clear();
+        if (safe)
+        {
+            batch_end.push_back(removed.size());
+            continue;
+        }
+        // 连锁会删除锚点：回滚本次删除并固定 v
+        for (int w : touched)
+            deg[w]++;
+        for (size_t i = first; i < removed.size(); ++i)
+            alive[removed[i]] = 1;
+        removed.resize(first);
+        fixed[v] = 1;
+    }
+
+    ComponentSets sets(n);
+    for (int v = 0; v < n; ++v)
+    {
+        if (alive[v])
+            sets.add(v, prob[v], is_anchor[v]);
+    }
+    for (int v = 0; v < n; ++v)
+    {
+        if (!alive[v])
+            continue;
+        for (int e = lg.und_offset[v]; e < lg.und_offset[v + 1]; ++e)
+        {
+            if (alive[lg.und_adj[e]])
+                sets.unite(v, lg.und_adj[e]);
+        }
+    }
+    const int best = best_state(sets, anchors, batch_end.size(), [&](int b)
+    {
+        const int begin = b > 0 ? batch_end[b - 1] : 0;
+        for (int i = begin; i < batch_end[b]; ++i)
+        {
+            alive[removed[i]] = 1;
+            sets.add(removed[i], prob[removed[i]], false);
+        }
+        for (int i = begin; i < batch_end[b]; ++i)
+        {
+            int v = removed[i];
+            for (int e = lg.und_offset[v]; e < lg.und_offset[v + 1]; ++e)
+            {
+                if (alive[lg.und_adj[e]])
+                    sets.unite(v, lg.und_adj[e]);
+            }
+        }
+    });
+
+    // 此时 alive 已恢复为初始社区，去掉最佳状态下仍被删除的节点
+    const int cut = best > 0 ? batch_end[best - 1] : 0;
+    for (int i = 0; i < cut; ++i)
+        alive[removed[i]] = 0;
+    return lg.component(anchors[0], alive);
+}
+
+// k-truss 约束：initial_edges 为初始社区（包含锚点的连通 k-truss）的边标记，min_support = k - 2。
+// 删除节点即删除它的全部关联边；节点在失去所有边时离开社区。返回平均概率最大的、包含全部锚点的连通 k-truss（局部ID）。
+inline vector<int> peel_max_average_truss(const LocalGraph &lg, const vector<double> &prob, const vector<char> &initial_edges,
+                                          int min_support, const vector<int> &anchors)
+{
+    using namespace influence_peel_detail;
+    const int n = lg.size(), m = lg.num_edges();
+    if (anchors.empty())
+        return {};
+    vector<char> edge_alive(initial_edges), queued(m, 0), fixed(n, 0), is_anchor(n, 0);
+    vector<int> support(m, 0), node_deg(n, 0);
+    for (int a : anchors)
+        fixed[a] = is_anchor[a] = 1;
+    for (int e = 0; e < m; ++e)
+    {
+        if (!edge_alive[e])
+            continue;
+        node_deg[lg.edge_u[e]]++;
+        node_deg[lg.edge_v[e]]++;
+        for_each_triangle_of_edge(lg, lg.edge_u[e], lg.edge_v[e], [&](int e1, int e2)
+        {
+            if (edge_alive[e1] && edge_alive[e2])
+                support[e]++;
+        });
+    }
+    MinHeap heap;
+    for (int v = 0; v < n; ++v)
+    {
+        if (node_deg[v] > 0 && !fixed[v])
+            heap.push({prob[v], v});
+    }
+
+    // killed 按删除顺序记录边，batch_end[b] 为第 b 批删除结束时 killed 的长度
+    vector<int> killed, batch_end, worklist, queued_log, support_log, deg_log;
+    while (!heap.empty())
+    {
+        int v = heap.top().second;
+        heap.pop();
+        if (node_deg[v] == 0 || fixed[v])
+            continue;
+
+        const size_t first = killed.size();
+        bool safe = true;
+        queued_log.clear();
+        support_log.clear();
+        deg_log.clear();
+        auto enqueue = [&](int e)
+        {
+            queued[e] = 1;
+            queued_log.push_back(e);
+            worklist.push_back(e);
+        };
+        for (int k = lg.und_offset[v]; k < lg.und_offset[v + 1]; ++k)
+        {
+            int e = lg.und_eid[k];
+            if (edge_alive[e] && !queued[e])
+                enqueue(e);
+        }
+        while (!worklist.empty() && safe)
+        {
+            int e = worklist.back();
+            worklist.pop_back();
+            edge_alive[e] = 0;
+            killed.push_back(e);
+            for (int x : {lg.edge_u[e], lg.edge_v[e]})
+            {
+                deg_log.push_back(x);
+                if (--node_deg[x] == 0 && x != v && fixed[x])
+                    safe = false;
+            }
+            if (!safe)
+                break;
+            for_each_triangle_of_edge(lg, lg.edge_u[e], lg.edge_v[e], [&](int e1, int e2)
+            {
+                if (!edge_alive[e1] || !edge_alive[e2])
+                    return;
+                for (int f : {e1, e2})
+                {
+                    if (queued[f])
+                        continue;
+                    support_log.push_back(f);
+                    if (--support[f] < min_support)
+                        enqueue(f);
+                }
+            });
+        }
+        worklist.clear();
+        if (safe)
+        {
+            batch_end.push_back(killed.size());
+            continue;
+        }
+        // 连锁会使锚点失去所有边：回滚本次删除并固定 v
+        for (int f : support_log)
+            support[f]++;
+        for (int x : deg_log)
+            node_deg[x]++;
+        for (int f : queued_log)
+            queued[f] = 0;
+        for (size_t i = first; i < killed.size(); ++i)
+            edge_alive[killed[i]] = 1;
+        killed.resize(first);
+        fixed[v] = 1;
+    }
+
+    ComponentSets sets(n);
+    vector<char> present(n, 0);
+    auto add_edge = [&](int e)
+    {
+        for (int x : {lg.edge_u[e], lg.edge_v[e]})
+        {
+            if (!present[x])
+            {
+                present[x] = 1;
+                sets.add(x, prob[x], is_anchor[x]);
+            }
+        }
+        sets.unite(lg.edge_u[e], lg.edge_v[e]);
+    };
+    for (int e = 0; e < m; ++e)
+    {
+        if (edge_alive[e])
+            add_edge(e);
+    }
+    const int best = best_state(sets, anchors, batch_end.size(), [&](int b)
+    {
+        for (int i = b > 0 ? batch_end[b - 1] : 0; i < batch_end[b]; ++i)
+            add_edge(killed[i]);
+    });
+
+    edge_alive = initial_edges;
+    const int cut = best > 0 ? batch_end[best - 1] : 0;
+    for (int i = 0; i < cut; ++i)
+        edge_alive[killed[i]] = 0;
+    return lg.edge_component(anchors[0], edge_alive);
+}
+
+#endif // INFLUENCE_PEEL_H
@@ -0,0 +1,264 @@
+#ifndef LIVE_EDGE_H
+#define LIVE_EDGE_H
+
+#include "infgraph.h"
+#include "parallel.h"
+
+// 从一组种子节点出发采样得到的活跃边(live-edge)子图，只保留可达部分。
+// 局部编号按BFS顺序分配，前 num_roots 个局部节点是种子。
+struct LiveEdgeSample
+{
+    vector<int> nodes;  // 局部编号 -> 全局节点ID
+    vector<int> offset; // CSR 偏移，长度为 nodes.size() + 1
+    vector<int> adj;    // 出邻居（局部编号）
+    vector<int> adj_eid; // 与 adj 对齐的全局边ID
+    int num_roots = 0;
+};
+
+// 活跃边(live-edge)样本的采样器：IC 下每条边以其概率独立保留，
+// LT 下每个节点按入边权重至多保留一条入边。
+class LiveEdgeSampler
+{
+private:
+    // 从种子出发，按当前传播模型采样一个活跃边子图（只展开可达部分）
+    static void sample_live_edge_graph(
+        const InfGraph &g,
+        const vector<int> &seeds,
+        sfmt_t *rng,
+        vector<int> &local_id,
+        vector<int> &lt_parent,
+        vector<int> &touched,
+        LiveEdgeSample &s)
+    {
+        s.nodes.clear();
+        s.adj.clear();
+        s.adj_eid.clear();
+        s.offset.assign(1, 0);
+        for (int seed : seeds)
+        {
+            if (seed >= 0 && seed < g.n && local_id[seed] == -1)
+            {
+                local_id[seed] = s.nodes.size();
+                s.nodes.push_back(seed);
+            }
+        }
+        s.num_roots = s.nodes.size();
+
+        for (size_t head = 0; head < s.nodes.size(); ++head)
+        {
+            int u = s.nodes[head];
+            for (size_t j = 0; j < g.g[u].size(); ++j)
+            {
+                int v = g.g[u][j];
+                bool live;
+                if (g.influModel == LT)
+                {
+                    // LT 的活跃边等价形式：每个节点按入边权重至多选中一个入邻居
+                    if (lt_parent[v] == -2)
+                    {
+                        lt_parent[v] = -1;
+                        double rand_val = sfmt_genrand_real1(rng);
+                        for (size_t i = 0; i < g.gT[v].size(); ++i)
+                        {
+                            rand_val -= (*g.active_probT)[v][i];
+                            if (rand_val <= 0)
+                            {
+                                lt_parent[v] = g.gT[v][i];
+                                break;
+                            }
+                        }
+                        touched.push_back(v);
+                    }
+                    live = (lt_parent[v] == u);
+                }
+                else
+                {
+                    live = sfmt_genrand_real1(rng) < (*g.active_probFwd)[u][j];
+                }
+                if (!live)
+                    continue;
+                if (local_id[v] == -1)
+                {
+                    local_id[v] = s.nodes.size();
+                    s.nodes.push_back(v);
+                }
+                s.adj.push_back(local_id[v]);
+                s.adj_eid.push_back(g.out_offset[u] + j);
+            }
+            s.offset.push_back(s.adj.size());
+        }
+
+        for (int v : s.nodes)
+            local_id[v] = -1;
+        for (int v : touched)
+            lt_parent[v] = -2;
+        touched.clear();
+    }
+
+public:
+    // 并行采样 num_samples 个活跃边子图，各线程使用独立的随机数流
+    static vector<LiveEdgeSample> sample_from_seeds(InfGraph &g, const vector<int> &seeds, int num_samples)
+    {
+        const int n = g.n;
+        const uint32_t base_seed = g.next_seed();
+        vector<LiveEdgeSample> samples(num_samples);
+        parallel_for(num_samples, g.num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            sfmt_t rng;
+            sfmt_init_gen_rand(&rng, base_seed + t);
+            vector<int> local_id(n, -1), lt_parent(n, -2), touched;
+            for (int64_t i = begin; i < end; ++i)
+                sample_live_edge_graph(g, seeds, &rng, local_id, lt_parent, touched, samples[i]);
+        });
+        return samples;
+    }
+};
+
+// 在一组固定的活跃边样本上增量评估“逐个加入阻塞节点（或删除边）”后的激活概率。
+// 所有阻塞前缀共享同一批样本（公共随机数），每加入一个阻塞节点只重算该节点仍可达的样本，
+// 每删除一条边只重算该边起点仍可达的样本，因此得到的激活概率随前缀单调不增。
+class IncrementalBlockingEvaluator
+{
+private:
+    int n;
+    int num_threads;
+    vector<LiveEdgeSample> samples;
+    vector<vector<char>> reached;               // reached[s][i]: 样本 s 中局部节点 i 当前是否可达
+    vector<vector<pair<int, int>>> occurrences; // 全局节点 -> (样本, 局部编号)
+    vector<vector<pair<int, int>>> edge_occurrences; // 边ID -> (样本, 起点局部编号)，首次删边时建立
+    vector<char> is_blocked, is_edge_blocked;
+    vector<int64_t> counts; // 每个节点在多少个样本中可达
+    vector<double> probs;
+
+    // 在删除已阻塞节点和已删除边后，重新计算样本 s 的可达集，并把失去可达性的节点追加到 lost
+    void recompute(int s, vector<char> &next, vector<int> &queue, vector<int> &lost) const
+    {
+        const LiveEdgeSample &sample = samples[s];
+        next.assign(sample.nodes.size(), 0);
+        queue.clear();
+        for (int i = 0; i < sample.num_roots; ++i)
+        {
+            if (!is_blocked[sample.nodes[i]])
+            {
+                next[i] = 1;
+                queue.push_back(i);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            int u = queue[head];
+            for (int k = sample.offset[u]; k < sample.offset[u + 1]; ++k)
+            {
+                int v = sample.adj[k];
+                if (!next[v] && !is_blocked[sample.nodes[v]] && !is_edge_blocked[sample.adj_eid[k]])
+                {
+                    next[v] = 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        for (size_t i = 0; i < sample.nodes.size(); ++i)
+        {
+            if (reached[s][i] && !next[i])
+                lost.push_back(sample.nodes[i]);
+        }
+    }
+
+    // 重算受影响的样本并更新计数
+    void recompute_samples(const vector<int> &affected)
+    {
+        vector<vector<char>> next_reached(affected.size());
+        vector<vector<int>> lost(num_threads);
+        parallel_for(affected.size(), num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            vector<int> queue;
+            for (int64_t i = begin; i < end; ++i)
+                recompute(affected[i], next_reached[i], queue, lost[t]);
+        });
+
+        for (size_t i = 0; i < affected.size(); ++i)
+            reached[affected[i]].swap(next_reached[i]);
+        for (const auto &list : lost)
+        {
+            for (int v : list)
+            {
+                counts[v]--;
+                probs[v] = (double)counts[v] / samples.size();
+            }
+        }
+    }
+
+public:
+    IncrementalBlockingEvaluator(InfGraph &g, const vector<int> &seeds, int num_samples)
+        : n(g.n), num_threads(g.num_threads), is_blocked(g.n, 0), is_edge_blocked(g.m, 0), counts(g.n, 0), probs(g.n, 0.0)
+    {
+        samples = LiveEdgeSampler::sample_from_seeds(g, seeds, num_samples);
+        reached.resize(samples.size());
+        occurrences.resize(n);
+        for (size_t s = 0; s < samples.size(); ++s)
+        {
+            // 采样时只展开可达部分，因此初始时样本中所有节点均可达
+            reached[s].assign(samples[s].nodes.size(), 1);
+            for (size_t i = 0; i < samples[s].nodes.size(); ++i)
+            {
+                int v = samples[s].nodes[i];
+                occurrences[v].push_back({(int)s, (int)i});
+                counts[v]++;
+            }
+        }
+        for (int v = 0; v < n; ++v)
+            probs[v] = samples.empty() ? 0.0 : (double)counts[v] / samples.size();
+    }
+
+    // 当前阻塞前缀下每个节点的激活概率
+    const vector<double> &probabilities() const { return probs; }
+
+    // 将 node 加入阻塞集合，只重算 node 当前仍可达的样本
+    void block(int node)
+    {
+        if (node < 0 || node >= n || is_blocked[node])
+            return;
+        is_blocked[node] = 1;
+
+        vector<int> affected;
+        for (const auto &occ : occurrences[node])
+        {
+            if (reached[occ.first][occ.second])
+                affected.push_back(occ.first);
+        }
+
+        recompute_samples(affected);
+    }
+
+    // 删除边 eid（全局边ID），只重算该边起点当前仍可达的样本
+    void block_edge(int eid)
+    {
+        if (eid < 0 || eid >= (int)is_edge_blocked.size() || is_edge_blocked[eid])
+            return;
+        is_edge_blocked[eid] = 1;
+
+        if (edge_occurrences.empty())
+        {
+            edge_occurrences.resize(is_edge_blocked.size());
+            for (size_t s = 0; s < samples.size(); ++s)
+            {
+                const LiveEdgeSample &sample = samples[s];
+                for (size_t u = 0; u < sample.nodes.size(); ++u)
+                {
+                    for (int k = sample.offset[u]; k < sample.offset[u + 1]; ++k)
+                        edge_occurrences[sample.adj_eid[k]].push_back({(int)s, (int)u});
+                }
+            }
+        }
+
+        vector<int> affected;
+        for (const auto &occ : edge_occurrences[eid])
+        {
+            if (reached[occ.first][occ.second])
+                affected.push_back(occ.first);
+        }
+        recompute_samples(affected);
+    }
+};
+
+#endif // LIVE_EDGE_H
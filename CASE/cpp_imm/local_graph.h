@@ -0,0 +1,452 @@
+#ifndef LOCAL_GRAPH_H
+#define LOCAL_GRAPH_H
+
+#include "graph.h"
+#include "parallel.h"
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+using std::vector;
+
+// 局部子图：把全图中的一个节点子集重新编号为 0..size()-1，并以 CSR 形式保存。
+// 社区搜索的剥离、连通分量提取都在局部编号上进行，成员判断只需访问稠密数组。
+struct LocalGraph
+{
+    vector<int> nodes;                 // 局部ID -> 全局ID
+    vector<int> local_of;              // 全局ID -> 局部ID，不在子图中为 -1
+    vector<int> out_offset, out_adj;   // 子图内的有向出边（保留重边）
+    vector<int> in_offset, in_adj;     // 子图内的有向入边（保留重边）
+    vector<int> und_offset, und_adj;   // 无向视图：去重、去自环，邻接表按局部ID升序
+    vector<int> und_eid;               // und_adj 中每个位置对应的无向边ID
+    vector<int> edge_u, edge_v;        // 无向边ID -> 端点（edge_u < edge_v）
+
+    int size() const { return (int)nodes.size(); }
+    int num_edges() const { return (int)edge_u.size(); }
+
+    void build(const Graph &g, const vector<int> &node_list)
+    {
+        nodes = node_list;
+        local_of.assign(g.n, -1);
+        for (size_t i = 0; i < nodes.size(); ++i)
+            local_of[nodes[i]] = i;
+        const int s = size();
+
+        out_offset.assign(s + 1, 0);
+        in_offset.assign(s + 1, 0);
+        out_adj.clear();
+        in_adj.clear();
+        for (int i = 0; i < s; ++i)
+        {
+            for (int v : g.g[nodes[i]])
+            {
+                if (local_of[v] >= 0)
+                    out_adj.push_back(local_of[v]);
+            }
+            out_offset[i + 1] = out_adj.size();
+            for (int v : g.gT[nodes[i]])
+            {
+                if (local_of[v] >= 0)
+                    in_adj.push_back(local_of[v]);
+            }
+            in_offset[i + 1] = in_adj.size();
+        }
+
+        // 无向视图：合并出入邻居后排序去重
+        und_offset.assign(s + 1, 0);
+        und_adj.clear();
+        und_adj.reserve(out_adj.size() + in_adj.size());
+        for (int i = 0; i < s; ++i)
+        {
+            size_t begin = und_adj.size();
+            for (int k = out_offset[i]; k < out_offset[i + 1]; ++k)
+                if (out_adj[k] != i)
+                    und_adj.push_back(out_adj[k]);
+            for (int k = in_offset[i]; k < in_offset[i + 1]; ++k)
+                if (in_adj[k] != i)
+                    und_adj.push_back(in_adj[k]);
+            std::sort(und_adj.begin() + begin, und_adj.end());
+            und_adj.erase(std::unique(und_adj.begin() + begin, und_adj.end()), und_adj.end());
+            und_offset[i + 1] = und_adj.size();
+        }
+
+        // 为每条无向边分配ID：按 u 升序处理 (u, v>u)，v 的邻接表中小于 v 的部分恰好按 u 升序被依次访问
+        und_eid.assign(und_adj.size(), -1);
+        edge_u.clear();
+        edge_v.clear();
+        vector<int> lower_cursor(und_offset.begin(), und_offset.end() - 1);
+        for (int u = 0; u < s; ++u)
+        {
+            for (int k = und_offset[u]; k < und_offset[u + 1]; ++k)
+            {
+                int v = und_adj[k];
+                if (v < u)
+                    continue;
+                int id = edge_u.size();
+                edge_u.push_back(u);
+                edge_v.push_back(v);
+                und_eid[k] = id;
+                und_eid[lower_cursor[v]++] = id;
+            }
+        }
+    }
+
+    // 从 start 出发，在 alive 节点上沿无向视图做 BFS
+    vector<int> component(int start, const vector<char> &alive) const
+    {
+        vector<int> comp;
+        if (start < 0 || !alive[start])
+            return comp;
+        vector<char> seen(size(), 0);
+        seen[start] = 1;
+        comp.push_back(start);
+        for (size_t head = 0; head < comp.size(); ++head)
+        {
+            int u = comp[head];
+            for (int k = und_offset[u]; k < und_offset[u + 1]; ++k)
+            {
+                int v = und_adj[k];
+                if (alive[v] && !seen[v])
+                {
+                    seen[v] = 1;
+                    comp.push_back(v);
+                }
+            }
+        }
+        return comp;
+    }
+
+    // 从 start 出发，只沿 edge_alive 中仍存在的无向边做 BFS
+    vector<int> edge_component(int start, const vector<char> &edge_alive) const
+    {
+        vector<int> comp;
+        if (start < 0)
+            return comp;
+        vector<char> seen(size(), 0);
+        seen[start] = 1;
+        comp.push_back(start);
+        for (size_t head = 0; head < comp.size(); ++head)
+        {
+            int u = comp[head];
+            for (int k = und_offset[u]; k < und_offset[u + 1]; ++k)
+            {
+                int v = und_adj[k];
+                if (edge_alive[und_eid[k]] && !seen[v])
+                {
+                    seen[v] = 1;
+                    comp.push_back(v);
+                }
+            }
+        }
+        if (comp.size() == 1)
+        {
+            // start 的所有边都已被删除：不构成社区
+            bool has_edge = false;
+            for (int k = und_offset[start]; k < und_offset[start + 1] && !has_edge; ++k)
+                has_edge = edge_alive[und_eid[k]];
+            if (!has_edge)
+                comp.clear();
+        }
+        return comp;
+    }
+};
+
+// Batagelj–Zaversnik 核分解：按度数做桶排序，每次取出度数最小的节点并把邻居移到低一级的桶，O(n + m)。
+// offset/adj 为无向图的 CSR（无重边、无自环），返回每个节点的核数。
+inline vector<int> core_numbers(const vector<int> &offset, const vector<int> &adj)
+{
+    const int n = (int)offset.size() - 1;
+    vector<int> deg(n), core(n);
+    int max_deg = 0;
+    for (int v = 0; v < n; ++v)
+    {
+        deg[v] = offset[v + 1] - offset[v];
+        max_deg = std::max(max_deg, deg[v]);
+    }
+
+    // bin[d] 为度数为 d 的桶在 vert 中的起始位置，pos[v] 为 v 在 vert 中的位置
+    vector<int> bin(max_deg + 1, 0), pos(n), vert(n);
+    for (int v = 0; v < n; ++v)
+        bin[deg[v]]++;
+    for (int d = 0, start = 0; d <= max_deg; ++d)
+    {
+        int cnt = bin[d];
+        bin[d] = start;
+        start += cnt;
+    }
+    for (int v = 0; v < n; ++v)
+    {
+        pos[v] = bin[deg[v]]++;
+        vert[pos[v]] = v;
+    }
+    for (int d = max_deg; d > 0; --d)
+        bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    for (int i = 0; i < n; ++i)
+    {
+        int v = vert[i];
+        core[v] = deg[v];
+        for (int k = offset[v]; k < offset[v + 1]; ++k)
+        {
+            int u = adj[k];
+            if (deg[u] > deg[v])
+            {
+                // 把 u 与其所在桶的第一个节点交换，再把桶边界右移，u 即落入低一级的桶
+                int du = deg[u], pu = pos[u];
+                int pw = bin[du], w = vert[pw];
+                if (u != w)
+                {
+                    pos[u] = pw;
+                    vert[pu] = w;
+                    pos[w] = pu;
+                    vert[pw] = u;
+                }
+                bin[du]++;
+                deg[u]--;
+            }
+        }
+    }
+    return core;
+}
+
+// 有向 (k,l)-core 剥离：反复删除子图内入度 < k 或出度 < l 的节点，返回幸存节点的标记
+inline vector<char> peel_kl_core(const LocalGraph &lg, int k, int l)
+{
+    const int s = lg.size();
+    vector<int> in_deg(s), out_deg(s), worklist;
+    vector<char> alive(s, 1), queued(s, 0);
+    for (int u = 0; u < s; ++u)
+    {
+        in_deg[u] = lg.in_offset[u + 1] - lg.in_offset[u];
+        out_deg[u] = lg.out_offset[u + 1] - lg.out_offset[u];
+        if (in_deg[u] < k || out_deg[u] < l)
+        {
+            queued[u] = 1;
+            worklist.push_back(u);
+        }
+    }
+    while (!worklist.empty())
+    {
+        int u = worklist.back();
+        worklist.pop_back();
+        alive[u] = 0;
+        // u 的入邻居失去一条出边，出邻居失去一条入边
+        for (int e = lg.in_offset[u]; e < lg.in_offset[u + 1]; ++e)
+        {
+            int v = lg.in_adj[e];
+            if (!queued[v] && --out_deg[v] < l)
+            {
+                queued[v] = 1;
+                worklist.push_back(v);
+            }
+        }
+        for (int e = lg.out_offset[u]; e < lg.out_offset[u + 1]; ++e)
+        {
+            int v = lg.out_adj[e];
+            if (!queued[v] && --in_deg[v] < k)
+            {
+                queued[v] = 1;
+                worklist.push_back(v);
+            }
+        }
+    }
+    return alive;
+}
+
+// 对无向边 (u, v) 所在的每个三角形 (u, v, w) 调用 fn(eid(u,w), eid(v,w))：两个有序邻接表的归并求交
+template <typename Fn>
+inline void for_each_triangle_of_edge(const LocalGraph &lg, int u, int v, Fn fn)
+{
+    int i = lg.und_offset[u], iend = lg.und_offset[u + 1];
+    int j = lg.und_offset[v], jend = lg.und_offset[v + 1];
+    while (i < iend && j < jend)
+    {
+        int a = lg.und_adj[i], b = lg.und_adj[j];
+        if (a < b)
+            ++i;
+        else if (a > b)
+            ++j;
+        else
+        {
+            fn(lg.und_eid[i], lg.und_eid[j]);
+            ++i;
+            ++j;
+        }
+    }
+}
+
+// 每条无向边的三角支持度。按 (度数, ID) 给节点定序，每条边只保留从低序指向高序的方向，
+// 再对每条定向边 (u, v) 归并求交 u、v 的定向出邻居表，每个三角形恰好被枚举一次，O(m^1.5)。
+// num_threads > 1 时按节点分段并行枚举，支持度用原子加累计（结果与线程数无关）。
+inline vector<int> edge_supports(const LocalGraph &lg, int num_threads = 1)
+{
+    const int s = lg.size();
+    auto precedes = [&](int a, int b)
+    {
+        int da = lg.und_offset[a + 1] - lg.und_offset[a], db = lg.und_offset[b + 1] - lg.und_offset[b];
+        return da < db || (da == db && a < b);
+    };
+    // 定向后的出邻居表（保持按ID升序）及对应的边ID
+    vector<int> o_offset(s + 1, 0), o_adj, o_eid;
+    o_adj.reserve(lg.num_edges());
+    o_eid.reserve(lg.num_edges());
+    for (int u = 0; u < s; ++u)
+    {
+        for (int k = lg.und_offset[u]; k < lg.und_offset[u + 1]; ++k)
+        {
+            if (precedes(u, lg.und_adj[k]))
+            {
+                o_adj.push_back(lg.und_adj[k]);
+                o_eid.push_back(lg.und_eid[k]);
+            }
+        }
+        o_offset[u + 1] = o_adj.size();
+    }
+
+    auto enumerate = [&](int u, auto &&count)
+    {
+        for (int a = o_offset[u]; a < o_offset[u + 1]; ++a)
+        {
+            int v = o_adj[a];
+            int i = o_offset[u], iend = o_offset[u + 1];
+            int j = o_offset[v], jend = o_offset[v + 1];
+            while (i < iend && j < jend)
+            {
+                if (o_adj[i] < o_adj[j])
+                    ++i;
+                else if (o_adj[i] > o_adj[j])
+                    ++j;
+                else
+                {
+                    count(o_eid[a]);
+                    count(o_eid[i]);
+                    count(o_eid[j]);
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+    };
+
+    vector<int> support(lg.num_edges(), 0);
+    if (num_threads <= 1)
+    {
+        for (int u = 0; u < s; ++u)
+            enumerate(u, [&](int e) { support[e]++; });
+        return support;
+    }
+    vector<std::atomic<int>> shared(lg.num_edges());
+    for (auto &x : shared)
+        x.store(0, std::memory_order_relaxed);
+    parallel_for(s, num_threads, [&](int, int64_t begin, int64_t end)
+    {
+        for (int64_t u = begin; u < end; ++u)
+            enumerate((int)u, [&](int e) { shared[e].fetch_add(1, std::memory_order_relaxed); });
+    });
+    for (int e = 0; e < lg.num_edges(); ++e)
+        support[e] = shared[e].load(std::memory_order_relaxed);
+    return support;
+}
+
+// k-truss 剥离：反复删除支持度（所在三角形数）< min_support 的边，返回幸存边的标记
+inline vector<char> peel_k_truss(const LocalGraph &lg, int min_support)
+{
+    const int m = lg.num_edges();
+    vector<int> support = edge_supports(lg), worklist;
+    vector<char> alive(m, 1), queued(m, 0);
+    for (int e = 0; e < m; ++e)
+    {
+        if (support[e] < min_support)
+        {
+            queued[e] = 1;
+            worklist.push_back(e);
+        }
+    }
+    while (!worklist.empty())
+    {
+        int e = worklist.back();
+        worklist.pop_back();
+        alive[e] = 0;
+        for_each_triangle_of_edge(lg, lg.edge_u[e], lg.edge_v[e], [&](int e1, int e2)
+        {
+            if (!alive[e1] || !alive[e2])
+                return;
+            if (!queued[e1] && --support[e1] < min_support)
+            {
+                queued[e1] = 1;
+                worklist.push_back(e1);
+            }
+            if (!queued[e2] && --support[e2] < min_support)
+            {
+                queued[e2] = 1;
+                worklist.push_back(e2);
+            }
+        });
+    }
+    return alive;
+}
+
+// 完整的 truss 分解：按支持度对边做桶排序，每次取出支持度最小的边 e，其 trussness 为支持度 + 2，
+// 并把与 e 构成三角形、尚未取出的边移到低一级的桶。返回每条边的 trussness。
+inline vector<int> truss_numbers(const LocalGraph &lg)
+{
+    const int m = lg.num_edges();
+    vector<int> support = edge_supports(lg), truss(m, 2);
+    int max_sup = 0;
+    for (int e = 0; e < m; ++e)
+        max_sup = std::max(max_sup, support[e]);
+
+    vector<int> bin(max_sup + 1, 0), pos(m), vert(m);
+    for (int e = 0; e < m; ++e)
+        bin[support[e]]++;
+    for (int d = 0, start = 0; d <= max_sup; ++d)
+    {
+        int cnt = bin[d];
+        bin[d] = start;
+        start += cnt;
+    }
+    for (int e = 0; e < m; ++e)
+    {
+        pos[e] = bin[support[e]]++;
+        vert[pos[e]] = e;
+    }
+    for (int d = max_sup; d > 0; --d)
+        bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    vector<char> processed(m, 0);
+    auto decrement = [&](int x, int floor_sup)
+    {
+        int dx = support[x];
+        if (dx <= floor_sup)
+            return;
+        int px = pos[x], py = bin[dx], y = vert[py];
+        if (x != y)
+        {
+            pos[x] = py;
+            vert[px] = y;
+            pos[y] = px;
+            vert[py] = x;
+        }
+        bin[dx]++;
+        support[x]--;
+    };
+    for (int i = 0; i < m; ++i)
+    {
+        int e = vert[i];
+        int s = support[e];
+        truss[e] = s + 2;
+        processed[e] = 1;
+        for_each_triangle_of_edge(lg, lg.edge_u[e], lg.edge_v[e], [&](int e1, int e2)
+        {
+            if (processed[e1] || processed[e2])
+                return;
+            decrement(e1, s);
+            decrement(e2, s);
+        });
+    }
+    return truss;
+}
+
+#endif // LOCAL_GRAPH_H
@@ -0,0 +1,43 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// 默认工作线程数：取硬件并发数，至少为 1
+inline int default_num_threads()
+{
+    unsigned int hc = std::thread::hardware_concurrency();
+    return hc == 0 ? 1 : (int)hc;
+}
+
+// 将 [0, count) 均匀切分为 num_threads 段，并行执行 fn(thread_id, begin, end)。
+// 切分方式只取决于 count 与 num_threads，因此每个线程使用由 thread_id 派生的
+// 独立随机数流时，结果对给定的种子和线程数是确定的。
+template <typename Fn>
+inline void parallel_for(int64_t count, int num_threads, Fn fn)
+{
+    if (count <= 0)
+        return;
+    num_threads = (int)std::max<int64_t>(1, std::min<int64_t>(num_threads, count));
+    if (num_threads == 1)
+    {
+        fn(0, (int64_t)0, count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t)
+    {
+        int64_t begin = count * t / num_threads;
+        int64_t end = count * (t + 1) / num_threads;
+        workers.emplace_back(fn, t, begin, end);
+    }
+    for (auto &w : workers)
+        w.join();
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,217 @@
+#ifndef PARALLEL_PEEL_H
+#define PARALLEL_PEEL_H
+
+#include "local_graph.h"
+#include "parallel.h"
+#include <atomic>
+#include <climits>
+
+// 层同步的并行剥离（ParK/PKC 风格的核分解，PKT 风格的 truss 分解）。
+// 每一层 level 先并行扫描剩余元素，得到度数（支持度）<= level 的前沿；各线程并行删除前沿中的元素，
+// 用原子操作递减邻居的度数：恰好从 level + 1 降到 level 的邻居进入本线程的下一轮前沿，
+// 已经 <= level 的（本轮已在前沿中）立即加回，使每个元素只被加入前沿一次。
+// 核数、trussness 以及给定阈值下的幸存集合都是唯一确定的，因此结果与顺序版本一致，与线程数无关。
+
+// 规模（边数）小于该值时顺序剥离更快：并行版本每一轮都要创建线程
+static const int PARALLEL_PEEL_MIN_EDGES = 1 << 16;
+
+namespace peel_detail
+{
+    // 前沿较小时只用一个线程
+    inline int threads_for(size_t work, int num_threads)
+    {
+        return work >= 4096 ? num_threads : 1;
+    }
+
+    inline void concat(vector<vector<int>> &local, int threads, vector<int> &out)
+    {
+        out.clear();
+        for (int t = 0; t < threads; ++t)
+        {
+            out.insert(out.end(), local[t].begin(), local[t].end());
+            local[t].clear();
+        }
+    }
+
+    // 并行筛选 items 中满足 pred 的元素，按线程顺序拼接到 out
+    template <typename Pred>
+    inline void parallel_filter(const vector<int> &items, int num_threads, vector<vector<int>> &local, vector<int> &out, Pred pred)
+    {
+        int threads = (int)std::max<size_t>(1, std::min<size_t>(threads_for(items.size(), num_threads), items.size()));
+        parallel_for(items.size(), threads, [&](int t, int64_t begin, int64_t end)
+        {
+            for (int64_t i = begin; i < end; ++i)
+            {
+                if (pred(items[i]))
+                    local[t].push_back(items[i]);
+            }
+        });
+        concat(local, threads, out);
+    }
+}
+
+// 节点剥离：从 first_level 到 last_level 逐层删除无向度数 <= level 的节点。
+// 返回每个节点被删除时的层级，剥离结束后仍幸存的节点为 INT_MAX。
+// first_level = 0、last_level = INT_MAX 时即为核数；first_level = last_level = k - 1 时幸存节点即为 k-core。
+inline vector<int> parallel_peel_nodes(const vector<int> &offset, const vector<int> &adj, int first_level, int last_level, int num_threads)
+{
+    const int n = (int)offset.size() - 1;
+    num_threads = std::max(1, num_threads);
+    vector<std::atomic<int>> deg(n);
+    vector<int> level_of(n, INT_MAX), remaining(n), frontier, scratch;
+    vector<char> removed(n, 0);
+    vector<vector<int>> local(num_threads);
+    for (int v = 0; v < n; ++v)
+    {
+        deg[v].store(offset[v + 1] - offset[v], std::memory_order_relaxed);
+        remaining[v] = v;
+    }
+
+    for (int level = first_level; level <= last_level && !remaining.empty(); ++level)
+    {
+        peel_detail::parallel_filter(remaining, num_threads, local, frontier,
+                                     [&](int v) { return deg[v].load(std::memory_order_relaxed) <= level; });
+        while (!frontier.empty())
+        {
+            for (int v : frontier)
+            {
+                removed[v] = 1;
+                level_of[v] = level;
+            }
+            int threads = peel_detail::threads_for(frontier.size(), num_threads);
+            parallel_for(frontier.size(), threads, [&](int t, int64_t begin, int64_t end)
+            {
+                for (int64_t i = begin; i < end; ++i)
+                {
+                    int v = frontier[i];
+                    for (int k = offset[v]; k < offset[v + 1]; ++k)
+                    {
+                        int u = adj[k];
+                        if (removed[u])
+                            continue;
+                        int before = deg[u].fetch_sub(1, std::memory_order_relaxed);
+                        if (before == level + 1)
+                            local[t].push_back(u);
+                        else if (before <= level)
+                            deg[u].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+            peel_detail::concat(local, threads, frontier);
+        }
+        scratch.swap(remaining);
+        peel_detail::parallel_filter(scratch, num_threads, local, remaining, [&](int v) { return !removed[v]; });
+        if (level == INT_MAX)
+            break;
+    }
+    return level_of;
+}
+
+// 边剥离：从 first_level 到 last_level 逐层删除支持度 <= level 的边，返回每条边被删除时的层级（幸存为 INT_MAX）。
+// 同一轮前沿中的边互相构成三角形时，只由边ID较小的一方为第三条边扣减一次支持度。
+inline vector<int> parallel_peel_edges(const LocalGraph &lg, const vector<int> &support, int first_level, int last_level, int num_threads)
+{
+    const int m = lg.num_edges();
+    num_threads = std::max(1, num_threads);
+    vector<std::atomic<int>> sup(m);
+    vector<int> level_of(m, INT_MAX), remaining(m), frontier, scratch;
+    vector<char> state(m, 0); // 0 存在，1 在本轮前沿中，2 已删除
+    vector<vector<int>> local(num_threads);
+    for (int e = 0; e < m; ++e)
+    {
+        sup[e].store(support[e], std::memory_order_relaxed);
+        remaining[e] = e;
+    }
+
+    for (int level = first_level; level <= last_level && !remaining.empty(); ++level)
+    {
+        peel_detail::parallel_filter(remaining, num_threads, local, frontier,
+                                     [&](int e) { return sup[e].load(std::memory_order_relaxed) <= level; });
+        while (!frontier.empty())
+        {
+            for (int e : frontier)
+            {
+                state[e] = 1;
+                level_of[e] = level;
+            }
+            int threads = peel_detail::threads_for(frontier.size(), num_threads);
+            parallel_for(frontier.size(), threads, [&](int t, int64_t begin, int64_t end)
+            {
+                auto decrement = [&](int x)
+                {
+                    int before = sup[x].fetch_sub(1, std::memory_order_relaxed);
+                    if (before == level + 1)
+                        local[t].push_back(x);
+                    else if (before <= level)
+                        sup[x].fetch_add(1, std::memory_order_relaxed);
+                };
+                for (int64_t i = begin; i < end; ++i)
+                {
+                    int e = frontier[i];
+                    for_each_triangle_of_edge(lg, lg.edge_u[e], lg.edge_v[e], [&](int e1, int e2)
+                    {
+                        char s1 = state[e1], s2 = state[e2];
+                        if (s1 == 2 || s2 == 2)
+                            return;
+                        if (s1 == 0 && s2 == 0)
+                        {
+                            decrement(e1);
+                            decrement(e2);
+                        }
+                        else if (s1 == 1 && s2 == 0)
+                        {
+                            if (e < e1)
+                                decrement(e2);
+                        }
+                        else if (s1 == 0 && s2 == 1)
+                        {
+                            if (e < e2)
+                                decrement(e1);
+                        }
+                    });
+                }
+            });
+            for (int e : frontier)
+                state[e] = 2;
+            peel_detail::concat(local, threads, frontier);
+        }
+        scratch.swap(remaining);
+        peel_detail::parallel_filter(scratch, num_threads, local, remaining, [&](int e) { return state[e] != 2; });
+        if (level == INT_MAX)
+            break;
+    }
+    return level_of;
+}
+
+// 按规模选择顺序或并行实现的核数计算
+inline vector<int> compute_core_numbers(const vector<int> &offset, const vector<int> &adj, int num_threads)
+{
+    if (num_threads <= 1 || (int64_t)adj.size() < 2LL * PARALLEL_PEEL_MIN_EDGES)
+        return core_numbers(offset, adj);
+    return parallel_peel_nodes(offset, adj, 0, INT_MAX, num_threads);
+}
+
+// 按规模选择顺序或并行实现的 truss 分解
+inline vector<int> compute_truss_numbers(const LocalGraph &lg, int num_threads)
+{
+    if (num_threads <= 1 || lg.num_edges() < PARALLEL_PEEL_MIN_EDGES)
+        return truss_numbers(lg);
+    vector<int> level = parallel_peel_edges(lg, edge_supports(lg, num_threads), 0, INT_MAX, num_threads);
+    for (int &x : level)
+        x += 2;
+    return level;
+}
+
+// 按规模选择顺序或并行实现的 k-truss 剥离（支持度 < min_support 的边被删除），返回幸存边的标记
+inline vector<char> compute_k_truss(const LocalGraph &lg, int min_support, int num_threads)
+{
+    if (num_threads <= 1 || lg.num_edges() < PARALLEL_PEEL_MIN_EDGES)
+        return peel_k_truss(lg, min_support);
+    vector<int> level = parallel_peel_edges(lg, edge_supports(lg, num_threads), min_support - 1, min_support - 1, num_threads);
+    vector<char> alive(lg.num_edges());
+    for (int e = 0; e < lg.num_edges(); ++e)
+        alive[e] = (level[e] == INT_MAX);
+    return alive;
+}
+
+#endif // PARALLEL_PEEL_H
@@ -0,0 +1,401 @@
+#ifndef PMC_H
+#define PMC_H
+
+#include "infgraph.h"
+#include "parallel.h"
+
+// 剪枝蒙特卡洛(Pruned Monte Carlo)：对每个采样得到的 IC 活跃边图做强连通分量缩点，
+// 得到以分量大小为权重的 DAG。每个世界选出度数最大的分量作为枢纽(hub)，预先求出其
+// 后代与祖先：若种子能到达枢纽，则枢纽的全部后代直接计入，BFS 在这些分量处剪枝。
+// 因此种子集合的可达规模通过 DAG 上的遍历得到，不再逐个节点展开。
+// 删除边会破坏分量结构，此时回退到原始活跃边上的节点级 BFS。
+class PrunedMonteCarlo
+{
+private:
+    struct World
+    {
+        vector<int> live_offset, live_adj; // 原始活跃边（CSR），用于阻塞节点落在非平凡分量或删除边时的回退
+        vector<int> live_eid;              // 与 live_adj 对齐的边ID
+        vector<int> comp_of;               // 节点 -> 分量
+        vector<int> comp_offset, comp_nodes; // 分量 -> 成员节点（CSR）
+        vector<int> dag_offset, dag_adj;   // 缩点后的 DAG（CSR）
+        int hub = -1;
+        vector<int> hub_desc;     // 枢纽可达的分量（含枢纽本身）
+        vector<char> hub_anc;     // hub_anc[c]: 分量 c 可达枢纽
+        int hub_desc_weight = 0;  // 枢纽后代分量的节点总数
+
+        int num_comps() const { return (int)comp_offset.size() - 1; }
+        int comp_size(int c) const { return comp_offset[c + 1] - comp_offset[c]; }
+    };
+
+    int n = 0;
+    vector<World> worlds;
+
+    // 每个线程查询时使用的临时数组，用时间戳标记有效性
+    struct Scratch
+    {
+        vector<int> reached, blocked, queue;
+        int epoch = 0;
+        explicit Scratch(int n) : reached(n, 0), blocked(n, 0) {}
+    };
+
+    // 迭代版 Tarjan 算法求强连通分量，并构建分量成员表与去重后的 DAG
+    static void condense(int n, World &w)
+    {
+        vector<int> index(n, -1), low(n, 0), stack, frames, cursor(n, 0);
+        vector<char> on_stack(n, 0);
+        w.comp_of.assign(n, -1);
+        int next_index = 0, num_comps = 0;
+
+        for (int s = 0; s < n; ++s)
+        {
+            if (index[s] != -1)
+                continue;
+            frames.push_back(s);
+            index[s] = low[s] = next_index++;
+            cursor[s] = w.live_offset[s];
+            stack.push_back(s);
+            on_stack[s] = 1;
+            while (!frames.empty())
+            {
+                int v = frames.back();
+                if (cursor[v] < w.live_offset[v + 1])
+                {
+                    int u = w.live_adj[cursor[v]++];
+                    if (index[u] == -1)
+                    {
+                        index[u] = low[u] = next_index++;
+                        cursor[u] = w.live_offset[u];
+                        stack.push_back(u);
+                        on_stack[u] = 1;
+                        frames.push_back(u);
+                    }
+                    else if (on_stack[u])
+                    {
+                        low[v] = min(low[v], index[u]);
+                    }
+                    continue;
+                }
+                frames.pop_back();
+                if (!frames.empty())
+                    low[frames.back()] = min(low[frames.back()], low[v]);
+                if (low[v] == index[v])
+                {
+                    int u;
+                    do
+                    {
+                        u = stack.back();
+                        stack.pop_back();
+                        on_stack[u] = 0;
+                        w.comp_of[u] = num_comps;
+                    } while (u != v);
+                    num_comps++;
+                }
+            }
+        }
+
+        // 分量成员表
+        w.comp_offset.assign(num_comps + 1, 0);
+        for (int v = 0; v < n; ++v)
+            w.comp_offset[w.comp_of[v] + 1]++;
+        for (int c = 0; c < num_comps; ++c)
+            w.comp_offset[c + 1] += w.comp_offset[c];
+        w.comp_nodes.resize(n);
+        vector<int> fill(w.comp_offset.begin(), w.comp_offset.end() - 1);
+        for (int v = 0; v < n; ++v)
+            w.comp_nodes[fill[w.comp_of[v]]++] = v;
+
+        // 去重后的分量间边
+        vector<int> stamp(num_comps, -1);
+        w.dag_offset.assign(1, 0);
+        w.dag_adj.clear();
+        for (int c = 0; c < num_comps; ++c)
+        {
+            stamp[c] = c;
+            for (int k = w.comp_offset[c]; k < w.comp_offset[c + 1]; ++k)
+            {
+                int u = w.comp_nodes[k];
+                for (int e = w.live_offset[u]; e < w.live_offset[u + 1]; ++e)
+                {
+                    int d = w.comp_of[w.live_adj[e]];
+                    if (stamp[d] != c)
+                    {
+                        stamp[d] = c;
+                        w.dag_adj.push_back(d);
+                    }
+                }
+            }
+            w.dag_offset.push_back(w.dag_adj.size());
+        }
+    }
+
+    // 选出 DAG 中度数最大的分量作为枢纽，预先求出它的后代与祖先
+    static void select_hub(World &w)
+    {
+        const int C = w.num_comps();
+        vector<int> in_deg(C, 0);
+        for (int d : w.dag_adj)
+            in_deg[d]++;
+        int best = -1;
+        for (int c = 0; c < C; ++c)
+        {
+            int deg = in_deg[c] + (w.dag_offset[c + 1] - w.dag_offset[c]);
+            if (best == -1 || deg > best)
+            {
+                best = deg;
+                w.hub = c;
+            }
+        }
+
+        vector<char> seen(C, 0);
+        w.hub_desc.assign(1, w.hub);
+        seen[w.hub] = 1;
+        for (size_t head = 0; head < w.hub_desc.size(); ++head)
+        {
+            int c = w.hub_desc[head];
+            w.hub_desc_weight += w.comp_size(c);
+            for (int e = w.dag_offset[c]; e < w.dag_offset[c + 1]; ++e)
+            {
+                int d = w.dag_adj[e];
+                if (!seen[d])
+                {
+                    seen[d] = 1;
+                    w.hub_desc.push_back(d);
+                }
+            }
+        }
+
+        // 反向 DAG 上从枢纽出发求祖先
+        vector<int> rev_offset(C + 1, 0), rev_adj(w.dag_adj.size());
+        for (int d : w.dag_adj)
+            rev_offset[d + 1]++;
+        for (int c = 0; c < C; ++c)
+            rev_offset[c + 1] += rev_offset[c];
+        vector<int> fill(rev_offset.begin(), rev_offset.end() - 1);
+        for (int c = 0; c < C; ++c)
+        {
+            for (int e = w.dag_offset[c]; e < w.dag_offset[c + 1]; ++e)
+                rev_adj[fill[w.dag_adj[e]]++] = c;
+        }
+        w.hub_anc.assign(C, 0);
+        vector<int> queue(1, w.hub);
+        w.hub_anc[w.hub] = 1;
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            int c = queue[head];
+            for (int e = rev_offset[c]; e < rev_offset[c + 1]; ++e)
+            {
+                int d = rev_adj[e];
+                if (!w.hub_anc[d])
+                {
+                    w.hub_anc[d] = 1;
+                    queue.push_back(d);
+                }
+            }
+        }
+    }
+
+    // 在一个世界上求种子集合的可达节点数；counts 非空时同时累加每个可达节点的计数。
+    // blocked_edges 为以边ID为下标的删除掩码（空表示不删边）
+    int reach(const World &w, const vector<int> &seeds, const vector<int> &blockers, const vector<char> &blocked_edges,
+              Scratch &sc, vector<int64_t> *counts) const
+    {
+        const int epoch = ++sc.epoch;
+        bool fallback = !blocked_edges.empty(), any_blocked = false;
+        for (int b : blockers)
+        {
+            if (b < 0 || b >= n)
+                continue;
+            if (w.comp_size(w.comp_of[b]) > 1)
+                fallback = true;
+            sc.blocked[w.comp_of[b]] = epoch;
+            any_blocked = true;
+        }
+
+        int total = 0;
+        sc.queue.clear();
+        if (fallback)
+        {
+            // 阻塞节点或删除边破坏了分量结构：直接在原始活跃边上做节点级 BFS
+            for (int b : blockers)
+            {
+                if (b >= 0 && b < n)
+                    sc.blocked[b] = -epoch;
+            }
+            for (int s : seeds)
+            {
+                if (s >= 0 && s < n && sc.blocked[s] != -epoch && sc.reached[s] != -epoch)
+                {
+                    sc.reached[s] = -epoch;
+                    sc.queue.push_back(s);
+                }
+            }
+            for (size_t head = 0; head < sc.queue.size(); ++head)
+            {
+                int u = sc.queue[head];
+                for (int e = w.live_offset[u]; e < w.live_offset[u + 1]; ++e)
+                {
+                    int v = w.live_adj[e];
+                    if (!blocked_edges.empty() && blocked_edges[w.live_eid[e]])
+                        continue;
+                    if (sc.reached[v] != -epoch && sc.blocked[v] != -epoch)
+                    {
+                        sc.reached[v] = -epoch;
+                        sc.queue.push_back(v);
+                    }
+                }
+            }
+            if (counts)
+            {
+                for (int v : sc.queue)
+                    (*counts)[v]++;
+            }
+            return sc.queue.size();
+        }
+
+        auto visit = [&](int c)
+        {
+            sc.reached[c] = epoch;
+            total += w.comp_size(c);
+            if (counts)
+            {
+                for (int k = w.comp_offset[c]; k < w.comp_offset[c + 1]; ++k)
+                    (*counts)[w.comp_nodes[k]]++;
+            }
+        };
+
+        // 枢纽剪枝：种子能到达枢纽时，枢纽的全部后代必然可达（有阻塞时不使用）
+        bool use_hub = false;
+        if (!any_blocked)
+        {
+            for (int s : seeds)
+            {
+                if (s >= 0 && s < n && w.hub_anc[w.comp_of[s]])
+                {
+                    use_hub = true;
+                    break;
+                }
+            }
+        }
+        if (use_hub)
+        {
+            for (int c : w.hub_desc)
+            {
+                sc.reached[c] = epoch;
+                if (counts)
+                {
+                    for (int k = w.comp_offset[c]; k < w.comp_offset[c + 1]; ++k)
+                        (*counts)[w.comp_nodes[k]]++;
+                }
+            }
+            total += w.hub_desc_weight;
+        }
+
+        for (int s : seeds)
+        {
+            if (s < 0 || s >= n)
+                continue;
+            int c = w.comp_of[s];
+            if (sc.reached[c] != epoch && sc.blocked[c] != epoch)
+            {
+                visit(c);
+                sc.queue.push_back(c);
+            }
+        }
+        for (size_t head = 0; head < sc.queue.size(); ++head)
+        {
+            int c = sc.queue[head];
+            for (int e = w.dag_offset[c]; e < w.dag_offset[c + 1]; ++e)
+            {
+                int d = w.dag_adj[e];
+                if (sc.reached[d] != epoch && sc.blocked[d] != epoch)
+                {
+                    visit(d);
+                    sc.queue.push_back(d);
+                }
+            }
+        }
+        return total;
+    }
+
+public:
+    // 采样 num_worlds 个 IC/WC 活跃边图并完成缩点与枢纽预处理，各线程使用独立的随机数流
+    PrunedMonteCarlo(InfGraph &g, int num_worlds) : PrunedMonteCarlo(g, num_worlds, g.next_seed()) {}
+
+    PrunedMonteCarlo(const InfGraph &g, int num_worlds, uint32_t base_seed) : n(g.n), worlds(num_worlds)
+    {
+        if (g.influModel == LT)
+            throw std::invalid_argument("Pruned Monte Carlo supports the IC model only.");
+        assert(g.active_probFwd != nullptr && "Forward probability model must be set.");
+        assert(num_worlds > 0 && "Number of worlds must be positive.");
+
+        parallel_for(num_worlds, g.num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            sfmt_t rng;
+            sfmt_init_gen_rand(&rng, base_seed + t);
+            for (int64_t i = begin; i < end; ++i)
+            {
+                World &w = worlds[i];
+                w.live_offset.assign(1, 0);
+                for (int u = 0; u < n; ++u)
+                {
+                    for (size_t j = 0; j < g.g[u].size(); ++j)
+                    {
+                        if (sfmt_genrand_real1(&rng) < (*g.active_probFwd)[u][j])
+                        {
+                            w.live_adj.push_back(g.g[u][j]);
+                            w.live_eid.push_back(g.out_offset[u] + j);
+                        }
+                    }
+                    w.live_offset.push_back(w.live_adj.size());
+                }
+                condense(n, w);
+                select_hub(w);
+            }
+        });
+    }
+
+    int size() const { return worlds.size(); }
+
+    // 期望激活节点数
+    double spread(const vector<int> &seeds, const vector<int> &blockers = {}, const vector<char> &blocked_edges = {},
+                  int num_threads = 1) const
+    {
+        vector<int64_t> thread_total(max(1, num_threads), 0);
+        parallel_for(worlds.size(), num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            Scratch sc(n);
+            for (int64_t i = begin; i < end; ++i)
+                thread_total[t] += reach(worlds[i], seeds, blockers, blocked_edges, sc, nullptr);
+        });
+        int64_t total = 0;
+        for (int64_t x : thread_total)
+            total += x;
+        return static_cast<double>(total) / worlds.size();
+    }
+
+    // 每个节点的激活概率
+    vector<double> final_probabilities(const vector<int> &seeds, const vector<int> &blockers = {},
+                                       const vector<char> &blocked_edges = {}, int num_threads = 1) const
+    {
+        vector<vector<int64_t>> thread_counts(max(1, num_threads));
+        parallel_for(worlds.size(), num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            Scratch sc(n);
+            thread_counts[t].assign(n, 0);
+            for (int64_t i = begin; i < end; ++i)
+                reach(worlds[i], seeds, blockers, blocked_edges, sc, &thread_counts[t]);
+        });
+        vector<double> probs(n, 0.0);
+        for (const auto &counts : thread_counts)
+        {
+            for (size_t v = 0; v < counts.size(); ++v)
+                probs[v] += counts[v];
+        }
+        for (int v = 0; v < n; ++v)
+            probs[v] /= worlds.size();
+        return probs;
+    }
+};
+
+#endif // PMC_H
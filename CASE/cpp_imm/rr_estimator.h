@@ -0,0 +1,311 @@
+#ifndef RR_ESTIMATOR_H
+#define RR_ESTIMATOR_H
+
+#include "infgraph.h"
+#include "parallel.h"
+
+// 基于一次性构建的反向可达集(RR set)池的期望影响力估计器。
+// 每个 RR 集除节点外还保存采样到的活跃反向边（局部编号与全局边ID），因此带阻塞节点或删除边的查询
+// 可以在受影响的 RR 集内部重新判定可达性，而不是把这些 RR 集整体视为被切断。
+// 查询只访问种子、阻塞节点和删除边的终点所在的 RR 集，代价为 O(|hyperG[seeds]| + |hyperG[blockers]|)
+// 加上其中同时含种子的 RR 集大小。构建完成后只读，可被多个线程同时查询。
+class RRSpreadEstimator
+{
+private:
+    int n = 0;
+    int m = 0;
+    int64_t num_sets = 0;
+    vector<int64_t> set_offset;  // RR 集 r 的节点为 nodes[set_offset[r], set_offset[r+1])，第一个是根
+    vector<int> nodes;           // 全局节点ID
+    vector<int64_t> edge_offset; // 扁平节点 k 的活跃入邻居为 edges[edge_offset[k], edge_offset[k+1])
+    vector<int> edges;           // 入邻居在所属 RR 集内的局部编号
+    vector<int> edge_ids;        // 与 edges 对齐的全局边ID（入邻居 -> 节点）
+    vector<int64_t> node_offset; // 节点 v 出现在 node_sets[node_offset[v], node_offset[v+1]) 这些 RR 集中
+    vector<int64_t> node_sets;
+    vector<int> edge_target;     // 边ID -> 终点
+
+    // 从 root 出发反向采样一个 RR 集，记录 RR 集内部的全部活跃边
+    static void sample_set(
+        const InfGraph &g,
+        int root,
+        sfmt_t *rng,
+        vector<int> &local_id,
+        vector<int> &out_nodes,
+        vector<int64_t> &out_edge_offset,
+        vector<int> &out_edges,
+        vector<int> &out_edge_ids)
+    {
+        size_t base = out_nodes.size();
+        local_id[root] = 0;
+        out_nodes.push_back(root);
+        for (size_t head = base; head < out_nodes.size(); ++head)
+        {
+            int u = out_nodes[head];
+            out_edge_offset.push_back(out_edges.size());
+            if (g.influModel == LT)
+            {
+                // LT：按入边权重轮盘赌，至多选中一个入邻居
+                double rand_val = sfmt_genrand_real1(rng);
+                for (size_t i = 0; i < g.gT[u].size(); ++i)
+                {
+                    rand_val -= (*g.active_probT)[u][i];
+                    if (rand_val <= 0)
+                    {
+                        int v = g.gT[u][i];
+                        if (local_id[v] == -1)
+                        {
+                            local_id[v] = out_nodes.size() - base;
+                            out_nodes.push_back(v);
+                        }
+                        out_edges.push_back(local_id[v]);
+                        out_edge_ids.push_back(g.in_eid[u][i]);
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                // IC/WC：每条入边独立抽样，已访问的邻居也要抽样以记录 RR 集内部的边
+                for (size_t i = 0; i < g.gT[u].size(); ++i)
+                {
+                    if (sfmt_genrand_real1(rng) >= (*g.active_probT)[u][i])
+                        continue;
+                    int v = g.gT[u][i];
+                    if (local_id[v] == -1)
+                    {
+                        local_id[v] = out_nodes.size() - base;
+                        out_nodes.push_back(v);
+                    }
+                    out_edges.push_back(local_id[v]);
+                    out_edge_ids.push_back(g.in_eid[u][i]);
+                }
+            }
+        }
+        for (size_t k = base; k < out_nodes.size(); ++k)
+            local_id[out_nodes[k]] = -1;
+    }
+
+    enum : char { SEED_NODE = 1, BLOCKED_NODE = 2 };
+    enum : char { PENDING_SET = 1, DONE_SET = 2 }; // 含阻塞节点（待判定）/ 已处理
+
+    // 查询用的线程私有临时数组，按“代”打标记：标记等于当前代的条目才有效，
+    // 因此查询之间不需要清零，每次查询只触碰种子、阻塞节点及其所在的 RR 集。
+    struct QueryScratch
+    {
+        uint32_t epoch = 0;
+        vector<uint32_t> set_mark, node_mark, edge_mark; // edge_mark 等于当前代表示该边被删除
+        vector<char> set_state, node_flags;
+        vector<char> seen;
+        vector<int> queue;
+
+        char node_flags_of(int v) const { return node_mark[v] == epoch ? node_flags[v] : 0; }
+
+        void mark_node(int v, char flag)
+        {
+            if (node_mark[v] != epoch)
+            {
+                node_mark[v] = epoch;
+                node_flags[v] = 0;
+            }
+            node_flags[v] |= flag;
+        }
+    };
+
+    // 开启新的一代；数组只在首次使用（或遇到更大的估计器）时扩容，代数回绕时整体清零一次
+    static QueryScratch &query_scratch(int64_t sets, int nodes, int num_edges)
+    {
+        thread_local QueryScratch q;
+        if (++q.epoch == 0)
+        {
+            std::fill(q.set_mark.begin(), q.set_mark.end(), 0);
+            std::fill(q.node_mark.begin(), q.node_mark.end(), 0);
+            std::fill(q.edge_mark.begin(), q.edge_mark.end(), 0);
+            q.epoch = 1;
+        }
+        if ((int64_t)q.set_mark.size() < sets)
+        {
+            q.set_mark.resize(sets, 0);
+            q.set_state.resize(sets, 0);
+        }
+        if ((int)q.node_mark.size() < nodes)
+        {
+            q.node_mark.resize(nodes, 0);
+            q.node_flags.resize(nodes, 0);
+        }
+        if ((int)q.edge_mark.size() < num_edges)
+            q.edge_mark.resize(num_edges, 0);
+        return q;
+    }
+
+public:
+    RRSpreadEstimator(InfGraph &g, int64_t R) : RRSpreadEstimator(g, R, g.next_seed()) {}
+
+    RRSpreadEstimator(const InfGraph &g, int64_t R, uint32_t base_seed) : n(g.n), m(g.m), num_sets(R)
+    {
+        assert(g.active_probT != nullptr && "Probability model must be set.");
+        assert(R > 0 && "Number of RR sets must be positive.");
+
+        // 1. 并行采样：每个线程写入私有的扁平缓冲区，再按线程顺序拼接
+        struct Chunk
+        {
+            vector<int64_t> set_offset, edge_offset;
+            vector<int> nodes, edges, edge_ids;
+        };
+        int threads = (int)std::max<int64_t>(1, std::min<int64_t>(g.num_threads, R));
+        vector<Chunk> chunks(threads);
+        parallel_for(R, threads, [&](int t, int64_t begin, int64_t end)
+        {
+            sfmt_t rng;
+            sfmt_init_gen_rand(&rng, base_seed + t);
+            vector<int> local_id(n, -1);
+            Chunk &c = chunks[t];
+            for (int64_t r = begin; r < end; ++r)
+            {
+                c.set_offset.push_back(c.nodes.size());
+                int root = sfmt_genrand_uint32(&rng) % n;
+                sample_set(g, root, &rng, local_id, c.nodes, c.edge_offset, c.edges, c.edge_ids);
+            }
+        });
+
+        set_offset.reserve(R + 1);
+        for (const Chunk &c : chunks)
+        {
+            int64_t node_base = nodes.size(), edge_base = edges.size();
+            for (int64_t off : c.set_offset)
+                set_offset.push_back(node_base + off);
+            for (int64_t off : c.edge_offset)
+                edge_offset.push_back(edge_base + off);
+            nodes.insert(nodes.end(), c.nodes.begin(), c.nodes.end());
+            edges.insert(edges.end(), c.edges.begin(), c.edges.end());
+            edge_ids.insert(edge_ids.end(), c.edge_ids.begin(), c.edge_ids.end());
+        }
+        set_offset.push_back(nodes.size());
+        edge_offset.push_back(edges.size());
+
+        edge_target.resize(m);
+        for (int u = 0; u < n; ++u)
+        {
+            for (size_t j = 0; j < g.g[u].size(); ++j)
+                edge_target[g.out_offset[u] + j] = g.g[u][j];
+        }
+
+        // 2. 建立 节点 -> RR 集 的倒排索引（CSR）
+        node_offset.assign(n + 1, 0);
+        for (int v : nodes)
+            node_offset[v + 1]++;
+        for (int v = 0; v < n; ++v)
+            node_offset[v + 1] += node_offset[v];
+        node_sets.resize(nodes.size());
+        vector<int64_t> cursor(node_offset.begin(), node_offset.end() - 1);
+        for (int64_t r = 0; r < R; ++r)
+        {
+            for (int64_t k = set_offset[r]; k < set_offset[r + 1]; ++k)
+                node_sets[cursor[nodes[k]]++] = r;
+        }
+    }
+
+    int64_t size() const { return num_sets; }
+
+    size_t memory_bytes() const
+    {
+        return (set_offset.size() + edge_offset.size() + node_offset.size() + node_sets.size()) * sizeof(int64_t) + (nodes.size() + edges.size() + edge_ids.size() + edge_target.size()) * sizeof(int);
+    }
+
+    // 期望激活节点数：被（未阻塞的）种子覆盖的 RR 集比例乘以 n。blocked_edge_ids 为删除的边ID。
+    // 含阻塞节点或删除边终点的 RR 集在删除阻塞节点和删除边后从根重新做一次 BFS 判定。
+    double estimate(const vector<int> &seed_nodes, const vector<int> &blocking_nodes = {},
+                    const vector<int> &blocked_edge_ids = {}) const
+    {
+        QueryScratch &q = query_scratch(num_sets, n, m);
+        const uint32_t epoch = q.epoch;
+        for (int b : blocking_nodes)
+        {
+            if (b >= 0 && b < n)
+                q.mark_node(b, BLOCKED_NODE);
+        }
+        for (int s : seed_nodes)
+        {
+            if (s >= 0 && s < n && !(q.node_flags_of(s) & BLOCKED_NODE))
+                q.mark_node(s, SEED_NODE);
+        }
+
+        // 含阻塞节点的 RR 集先标记为待判定；删除边只可能出现在含其终点的 RR 集中
+        auto mark_pending = [&](int v)
+        {
+            for (int64_t k = node_offset[v]; k < node_offset[v + 1]; ++k)
+            {
+                q.set_mark[node_sets[k]] = epoch;
+                q.set_state[node_sets[k]] = PENDING_SET;
+            }
+        };
+        for (int b : blocking_nodes)
+        {
+            if (b >= 0 && b < n)
+                mark_pending(b);
+        }
+        for (int eid : blocked_edge_ids)
+        {
+            if (eid < 0 || eid >= m || q.edge_mark[eid] == epoch)
+                continue;
+            q.edge_mark[eid] = epoch;
+            mark_pending(edge_target[eid]);
+        }
+
+        int64_t covered = 0;
+        for (int s : seed_nodes)
+        {
+            if (s < 0 || s >= n || !(q.node_flags_of(s) & SEED_NODE))
+                continue;
+            for (int64_t k = node_offset[s]; k < node_offset[s + 1]; ++k)
+            {
+                int64_t r = node_sets[k];
+                bool has_blocker = false;
+                if (q.set_mark[r] == epoch)
+                {
+                    if (q.set_state[r] == DONE_SET)
+                        continue;
+                    has_blocker = true;
+                }
+                q.set_mark[r] = epoch;
+                q.set_state[r] = DONE_SET;
+                if (!has_blocker)
+                {
+                    covered++;
+                    continue;
+                }
+
+                const int64_t first = set_offset[r];
+                const int size = set_offset[r + 1] - first;
+                if (q.node_flags_of(nodes[first]) & BLOCKED_NODE)
+                    continue;
+                q.seen.assign(size, 0);
+                q.queue.assign(1, 0);
+                q.seen[0] = 1;
+                bool reached = false;
+                for (size_t head = 0; head < q.queue.size() && !reached; ++head)
+                {
+                    int u = q.queue[head];
+                    if (q.node_flags_of(nodes[first + u]) & SEED_NODE)
+                    {
+                        reached = true;
+                        break;
+                    }
+                    for (int64_t e = edge_offset[first + u]; e < edge_offset[first + u + 1]; ++e)
+                    {
+                        int v = edges[e];
+                        if (!q.seen[v] && !(q.node_flags_of(nodes[first + v]) & BLOCKED_NODE) && q.edge_mark[edge_ids[e]] != epoch)
+                        {
+                            q.seen[v] = 1;
+                            q.queue.push_back(v);
+                        }
+                    }
+                }
+                if (reached)
+                    covered++;
+            }
+        }
+        return static_cast<double>(covered) / num_sets * n;
+    }
+};
+
+#endif // RR_ESTIMATOR_H
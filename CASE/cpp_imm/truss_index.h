@@ -0,0 +1,69 @@
+#ifndef TRUSS_INDEX_H
+#define TRUSS_INDEX_H
+
+#include "parallel_peel.h"
+#include <memory>
+
+// truss 分解索引：全图快照上每条无向边的 trussness（所在的最大 k-truss 的 k）。
+// 包含节点 v 的连通 k-truss 就是从 v 出发、只沿 trussness >= k 的边做遍历得到的分量，
+// 因此任意 k 的查询都不再需要重新计算三角形。每个数据集只需构建一次，构建后只读。
+class TrussIndex
+{
+private:
+    std::shared_ptr<const LocalGraph> graph; // 全图快照（局部ID与全局ID一致）
+    vector<int> truss;                       // 边ID -> trussness
+    vector<int> node_truss;                  // 节点关联边的最大 trussness（孤立节点为 0）
+    int max_truss_ = 0;
+
+public:
+    // 大图上支持度计算与边剥离都按层并行
+    explicit TrussIndex(std::shared_ptr<const LocalGraph> snapshot, int num_threads = default_num_threads()) : graph(std::move(snapshot))
+    {
+        const LocalGraph &lg = *graph;
+        truss = compute_truss_numbers(lg, num_threads);
+        node_truss.assign(lg.size(), 0);
+        for (int e = 0; e < lg.num_edges(); ++e)
+        {
+            node_truss[lg.edge_u[e]] = std::max(node_truss[lg.edge_u[e]], truss[e]);
+            node_truss[lg.edge_v[e]] = std::max(node_truss[lg.edge_v[e]], truss[e]);
+            max_truss_ = std::max(max_truss_, truss[e]);
+        }
+    }
+
+    int size() const { return (int)node_truss.size(); }
+    int max_truss() const { return max_truss_; }
+    int edge_truss(int eid) const { return truss[eid]; }
+    int node_truss_number(int v) const { return node_truss[v]; }
+
+    size_t memory_bytes() const
+    {
+        return (truss.size() + node_truss.size()) * sizeof(int);
+    }
+
+    // 包含 v 的连通 k-truss 的节点（v 没有 trussness >= k 的关联边时为空），按遍历顺序排列
+    vector<int> community(int v, int k) const
+    {
+        if (v < 0 || v >= size() || node_truss[v] < k)
+            return {};
+        const LocalGraph &lg = *graph;
+        vector<int> comp(1, v);
+        vector<char> seen(lg.size(), 0);
+        seen[v] = 1;
+        for (size_t head = 0; head < comp.size(); ++head)
+        {
+            int u = comp[head];
+            for (int e = lg.und_offset[u]; e < lg.und_offset[u + 1]; ++e)
+            {
+                int w = lg.und_adj[e];
+                if (truss[lg.und_eid[e]] >= k && !seen[w])
+                {
+                    seen[w] = 1;
+                    comp.push_back(w);
+                }
+            }
+        }
+        return comp;
+    }
+};
+
+#endif // TRUSS_INDEX_H
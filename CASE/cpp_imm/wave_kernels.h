@@ -0,0 +1,218 @@
+#ifndef WAVE_KERNELS_H
+#define WAVE_KERNELS_H
+
+#include <cstdint>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define WAVE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// 禁止编译器把 a - b * c 融合成 FMA，否则支持 FMA 的指令集版本会与其余版本产生舍入差异
+#if defined(__clang__)
+#define WAVE_NO_CONTRACT
+#define WAVE_NO_CONTRACT_BODY _Pragma("clang fp contract(off)")
+#elif defined(__GNUC__)
+#define WAVE_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#define WAVE_NO_CONTRACT_BODY
+#else
+#define WAVE_NO_CONTRACT
+#define WAVE_NO_CONTRACT_BODY
+#endif
+
+// 概率波内核：在 CSR 入边上（src 为入邻居，w 为连续存放的边权）计算
+//   IC: prod_j (1 - prob[src[j]] * w[j])      LT: sum_j prob[src[j]] * w[j]
+// 三个版本都按 j % 8 分成 8 路部分积/部分和，再以固定的树形顺序合并，余下不足 8 个的
+// 元素顺序处理，因此标量、AVX2、AVX-512 版本的结果逐位一致，与运行的机器无关。
+namespace wave_kernels
+{
+    inline double combine_product(const double lanes[8])
+    {
+        return ((lanes[0] * lanes[1]) * (lanes[2] * lanes[3])) * ((lanes[4] * lanes[5]) * (lanes[6] * lanes[7]));
+    }
+
+    inline double combine_sum(const double lanes[8])
+    {
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+
+    WAVE_NO_CONTRACT inline double ic_not_activated_scalar(const int *src, const double *w, int len, const double *prob)
+    {
+        WAVE_NO_CONTRACT_BODY
+        double acc[8] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+        int j = 0;
+        for (; j + 8 <= len; j += 8)
+        {
+            for (int l = 0; l < 8; ++l)
+                acc[l] *= 1.0 - prob[src[j + l]] * w[j + l];
+        }
+        double r = combine_product(acc);
+        for (; j < len; ++j)
+            r *= 1.0 - prob[src[j]] * w[j];
+        return r;
+    }
+
+    WAVE_NO_CONTRACT inline double lt_weighted_sum_scalar(const int *src, const double *w, int len, const double *prob)
+    {
+        WAVE_NO_CONTRACT_BODY
+        double acc[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        int j = 0;
+        for (; j + 8 <= len; j += 8)
+        {
+            for (int l = 0; l < 8; ++l)
+                acc[l] += prob[src[j + l]] * w[j + l];
+        }
+        double r = combine_sum(acc);
+        for (; j < len; ++j)
+            r += prob[src[j]] * w[j];
+        return r;
+    }
+
+#ifdef WAVE_KERNELS_X86
+    __attribute__((target("avx2"))) WAVE_NO_CONTRACT inline double ic_not_activated_avx2(const int *src, const double *w, int len, const double *prob)
+    {
+        WAVE_NO_CONTRACT_BODY
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        __m256d lo = one, hi = one;
+        int j = 0;
+        for (; j + 8 <= len; j += 8)
+        {
+            __m256d p_lo = _mm256_mask_i32gather_pd(zero, prob, _mm_loadu_si128((const __m128i *)(src + j)), all, 8);
+            __m256d p_hi = _mm256_mask_i32gather_pd(zero, prob, _mm_loadu_si128((const __m128i *)(src + j + 4)), all, 8);
+            lo = _mm256_mul_pd(lo, _mm256_sub_pd(one, _mm256_mul_pd(p_lo, _mm256_loadu_pd(w + j))));
+            hi = _mm256_mul_pd(hi, _mm256_sub_pd(one, _mm256_mul_pd(p_hi, _mm256_loadu_pd(w + j + 4))));
+        }
+        double lanes[8];
+        _mm256_storeu_pd(lanes, lo);
+        _mm256_storeu_pd(lanes + 4, hi);
+        double r = combine_product(lanes);
+        for (; j < len; ++j)
+            r *= 1.0 - prob[src[j]] * w[j];
+        return r;
+    }
+
+    __attribute__((target("avx2"))) WAVE_NO_CONTRACT inline double lt_weighted_sum_avx2(const int *src, const double *w, int len, const double *prob)
+    {
+        WAVE_NO_CONTRACT_BODY
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        __m256d lo = zero, hi = zero;
+        int j = 0;
+        for (; j + 8 <= len; j += 8)
+        {
+            __m256d p_lo = _mm256_mask_i32gather_pd(zero, prob, _mm_loadu_si128((const __m128i *)(src + j)), all, 8);
+            __m256d p_hi = _mm256_mask_i32gather_pd(zero, prob, _mm_loadu_si128((const __m128i *)(src + j + 4)), all, 8);
+            lo = _mm256_add_pd(lo, _mm256_mul_pd(p_lo, _mm256_loadu_pd(w + j)));
+            hi = _mm256_add_pd(hi, _mm256_mul_pd(p_hi, _mm256_loadu_pd(w + j + 4)));
+        }
+        double lanes[8];
+        _mm256_storeu_pd(lanes, lo);
+        _mm256_storeu_pd(lanes + 4, hi);
+        double r = combine_sum(lanes);
+        for (; j < len; ++j)
+            r += prob[src[j]] * w[j];
+        return r;
+    }
+
+    __attribute__((target("avx512f"))) WAVE_NO_CONTRACT inline double ic_not_activated_avx512(const int *src, const double *w, int len, const double *prob)
+    {
+        WAVE_NO_CONTRACT_BODY
+        const __m512d one = _mm512_set1_pd(1.0);
+        const __m512d zero = _mm512_setzero_pd();
+        __m512d acc = one;
+        int j = 0;
+        for (; j + 8 <= len; j += 8)
+        {
+            __m512d p = _mm512_mask_i32gather_pd(zero, 0xFF, _mm256_loadu_si256((const __m256i *)(src + j)), prob, 8);
+            acc = _mm512_mul_pd(acc, _mm512_sub_pd(one, _mm512_mul_pd(p, _mm512_loadu_pd(w + j))));
+        }
+        double lanes[8];
+        _mm512_storeu_pd(lanes, acc);
+        double r = combine_product(lanes);
+        for (; j < len; ++j)
+            r *= 1.0 - prob[src[j]] * w[j];
+        return r;
+    }
+
+    __attribute__((target("avx512f"))) WAVE_NO_CONTRACT inline double lt_weighted_sum_avx512(const int *src, const double *w, int len, const double *prob)
+    {
+        WAVE_NO_CONTRACT_BODY
+        const __m512d zero = _mm512_setzero_pd();
+        __m512d acc = zero;
+        int j = 0;
+        for (; j + 8 <= len; j += 8)
+        {
+            __m512d p = _mm512_mask_i32gather_pd(zero, 0xFF, _mm256_loadu_si256((const __m256i *)(src + j)), prob, 8);
+            acc = _mm512_add_pd(acc, _mm512_mul_pd(p, _mm512_loadu_pd(w + j)));
+        }
+        double lanes[8];
+        _mm512_storeu_pd(lanes, acc);
+        double r = combine_sum(lanes);
+        for (; j < len; ++j)
+            r += prob[src[j]] * w[j];
+        return r;
+    }
+#endif
+
+    // 运行时检测到的指令集，只检测一次
+    enum Isa
+    {
+        ISA_SCALAR,
+        ISA_AVX2,
+        ISA_AVX512
+    };
+
+    inline Isa detect_isa()
+    {
+#ifdef WAVE_KERNELS_X86
+        static const Isa isa = []()
+        {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return ISA_AVX512;
+            if (__builtin_cpu_supports("avx2"))
+                return ISA_AVX2;
+            return ISA_SCALAR;
+        }();
+        return isa;
+#else
+        return ISA_SCALAR;
+#endif
+    }
+
+    inline double ic_not_activated(const int *src, const double *w, int len, const double *prob)
+    {
+#ifdef WAVE_KERNELS_X86
+        switch (detect_isa())
+        {
+        case ISA_AVX512:
+            return ic_not_activated_avx512(src, w, len, prob);
+        case ISA_AVX2:
+            return ic_not_activated_avx2(src, w, len, prob);
+        default:
+            break;
+        }
+#endif
+        return ic_not_activated_scalar(src, w, len, prob);
+    }
+
+    inline double lt_weighted_sum(const int *src, const double *w, int len, const double *prob)
+    {
+#ifdef WAVE_KERNELS_X86
+        switch (detect_isa())
+        {
+        case ISA_AVX512:
+            return lt_weighted_sum_avx512(src, w, len, prob);
+        case ISA_AVX2:
+            return lt_weighted_sum_avx2(src, w, len, prob);
+        default:
+            break;
+        }
+#endif
+        return lt_weighted_sum_scalar(src, w, len, prob);
+    }
+}
+
+#endif // WAVE_KERNELS_H
@@ -0,0 +1,258 @@
+#ifndef WORLD_STORE_H
+#define WORLD_STORE_H
+
+#include "infgraph.h"
+#include "parallel.h"
+
+// 预先采样的一组可能世界（活跃边快照）。按边ID存储位掩码：live[b * m + e] 的第 i 位
+// 表示世界 64*b+i 中边 e 是否保留，每个世界每条边只占 1 位。
+// IC/WC 下每条边以其传播概率独立保留；LT 下每个节点按入边权重至多保留一条入边。
+// 采样与种子无关，因此任意种子/阻塞组合都可以在同一批世界上求值（公共随机数），
+// 相邻两次查询之间的差异只来自种子/阻塞本身，而不是蒙特卡洛噪声。
+class WorldStore
+{
+private:
+    int n = 0;
+    int m = 0;
+    int num_worlds = 0;
+    int num_batches = 0;
+    vector<uint64_t> live;
+
+    // 第 b 批中有效世界对应的位
+    uint64_t batch_lanes(int b) const
+    {
+        int worlds = min(64, num_worlds - b * 64);
+        return worlds == 64 ? ~0ULL : ((1ULL << worlds) - 1);
+    }
+
+public:
+    WorldStore(InfGraph &g, int worlds) : WorldStore(g, worlds, g.next_seed()) {}
+
+    // base_seed 决定采样结果：相同的图、世界数与 base_seed 总是得到相同的世界
+    WorldStore(const InfGraph &g, int worlds, uint32_t base_seed) : n(g.n), m(g.m), num_worlds(worlds)
+    {
+        assert(worlds > 0 && "Number of worlds must be positive.");
+        num_batches = (worlds + 63) / 64;
+        live.assign((size_t)num_batches * m, 0);
+
+        parallel_for(num_batches, g.num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            sfmt_t rng;
+            sfmt_init_gen_rand(&rng, base_seed + t);
+            for (int64_t b = begin; b < end; ++b)
+            {
+                uint64_t lanes = batch_lanes(b);
+                uint64_t *words = live.data() + b * m;
+                if (g.influModel == LT)
+                {
+                    // 每个世界中，每个节点用一次轮盘赌选出至多一条入边
+                    for (int v = 0; v < n; ++v)
+                    {
+                        for (uint64_t rest = lanes; rest; rest &= rest - 1)
+                        {
+                            double rand_val = sfmt_genrand_real1(&rng);
+                            for (size_t i = 0; i < g.gT[v].size(); ++i)
+                            {
+                                rand_val -= (*g.active_probT)[v][i];
+                                if (rand_val <= 0)
+                                {
+                                    words[g.in_eid[v][i]] |= rest & (~rest + 1);
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    for (int u = 0; u < n; ++u)
+                    {
+                        for (size_t j = 0; j < g.g[u].size(); ++j)
+                            words[g.out_offset[u] + j] = bernoulli_mask64((*g.active_probFwd)[u][j], lanes, &rng);
+                    }
+                }
+            }
+        });
+    }
+
+    int size() const { return num_worlds; }
+
+    size_t memory_bytes() const { return live.size() * sizeof(uint64_t); }
+
+    // 在全部世界上做位并行 BFS，返回每个节点在多少比例的世界中被激活。
+    // 被阻塞的节点不会被激活（作为种子也不会），被阻塞的边（以边ID为下标的掩码）不会传播。
+    vector<double> final_probabilities(
+        const InfGraph &g,
+        const vector<int> &initial_nodes,
+        const vector<int> &blocking_nodes = {},
+        const vector<char> &blocked_edges = {},
+        int num_threads = default_num_threads()) const
+    {
+        vector<char> is_blocked(n, 0);
+        for (int node : blocking_nodes)
+        {
+            if (node >= 0 && node < n)
+                is_blocked[node] = 1;
+        }
+
+        vector<vector<int64_t>> thread_counts(max(1, num_threads));
+        parallel_for(num_batches, num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            vector<int64_t> &counts = thread_counts[t];
+            counts.assign(n, 0);
+            vector<uint64_t> active(n, 0), pending(n, 0);
+            vector<int> frontier, touched;
+
+            for (int64_t b = begin; b < end; ++b)
+            {
+                const uint64_t lanes = batch_lanes(b);
+                const uint64_t *words = live.data() + b * m;
+                frontier.clear();
+                touched.clear();
+                for (int seed : initial_nodes)
+                {
+                    if (seed >= 0 && seed < n && !is_blocked[seed] && !active[seed])
+                    {
+                        active[seed] = lanes;
+                        pending[seed] = lanes;
+                        frontier.push_back(seed);
+                        touched.push_back(seed);
+                    }
+                }
+
+                for (size_t head = 0; head < frontier.size(); ++head)
+                {
+                    int u = frontier[head];
+                    uint64_t fresh = pending[u];
+                    pending[u] = 0;
+                    for (size_t j = 0; j < g.g[u].size(); ++j)
+                    {
+                        int v = g.g[u][j];
+                        if (is_blocked[v] || g.is_edge_blocked(blocked_edges, u, j))
+                            continue;
+                        uint64_t hit = fresh & words[g.out_offset[u] + j] & ~active[v];
+                        if (!hit)
+                            continue;
+                        if (!active[v])
+                            touched.push_back(v);
+                        active[v] |= hit;
+                        if (!pending[v])
+                            frontier.push_back(v);
+                        pending[v] |= hit;
+                    }
+                }
+
+                for (int v : touched)
+                {
+                    counts[v] += popcount64(active[v]);
+                    active[v] = 0;
+                }
+            }
+        });
+
+        vector<double> probs(n, 0.0);
+        for (const auto &counts : thread_counts)
+        {
+            for (size_t v = 0; v < counts.size(); ++v)
+                probs[v] += counts[v];
+        }
+        for (int v = 0; v < n; ++v)
+            probs[v] /= num_worlds;
+        return probs;
+    }
+    // 逐批做按层同步的位并行 BFS，报告每个世界中的激活边。世界中的节点在第一次被到达的那一层激活，
+    // 激活它的边取同一层中最先处理到的活跃入边，因此每个世界的激活边构成一棵以种子为根的传播树。
+    // 每组激活调用 on_edge(t, b, eid, u, v, level, hit)：hit 为本批中边 eid = (u, v) 在第 level 层激活 v 的世界；
+    // 每批结束时调用 on_batch(t, b, lanes, level_masks)：level_masks[d] 为第 d 层有新激活的世界（第 0 层为种子）。
+    // t 为线程编号，不同线程的回调并发执行。
+    template <typename OnEdge, typename OnBatch>
+    void trace_activations(
+        const InfGraph &g,
+        const vector<int> &initial_nodes,
+        const vector<int> &blocking_nodes,
+        const vector<char> &blocked_edges,
+        int num_threads,
+        OnEdge on_edge,
+        OnBatch on_batch) const
+    {
+        vector<char> is_blocked(n, 0);
+        for (int node : blocking_nodes)
+        {
+            if (node >= 0 && node < n)
+                is_blocked[node] = 1;
+        }
+
+        parallel_for(num_batches, num_threads, [&](int t, int64_t begin, int64_t end)
+        {
+            vector<uint64_t> active(n, 0), next_mask(n, 0), frontier_mask, level_masks;
+            vector<int> frontier, next, touched;
+
+            for (int64_t b = begin; b < end; ++b)
+            {
+                const uint64_t lanes = batch_lanes(b);
+                const uint64_t *words = live.data() + b * m;
+                frontier.clear();
+                frontier_mask.clear();
+                touched.clear();
+                level_masks.clear();
+                for (int seed : initial_nodes)
+                {
+                    if (seed >= 0 && seed < n && !is_blocked[seed] && !active[seed])
+                    {
+                        active[seed] = lanes;
+                        frontier.push_back(seed);
+                        frontier_mask.push_back(lanes);
+                        touched.push_back(seed);
+                    }
+                }
+                if (!frontier.empty())
+                    level_masks.push_back(lanes);
+
+                for (int level = 1; !frontier.empty(); ++level)
+                {
+                    next.clear();
+                    uint64_t level_mask = 0;
+                    for (size_t i = 0; i < frontier.size(); ++i)
+                    {
+                        const int u = frontier[i];
+                        const uint64_t fresh = frontier_mask[i];
+                        for (size_t j = 0; j < g.g[u].size(); ++j)
+                        {
+                            int v = g.g[u][j];
+                            if (is_blocked[v] || g.is_edge_blocked(blocked_edges, u, j))
+                                continue;
+                            const int eid = g.out_offset[u] + j;
+                            uint64_t hit = fresh & words[eid] & ~active[v];
+                            if (!hit)
+                                continue;
+                            if (!active[v])
+                                touched.push_back(v);
+                            if (!next_mask[v])
+                                next.push_back(v);
+                            active[v] |= hit;
+                            next_mask[v] |= hit;
+                            level_mask |= hit;
+                            on_edge(t, b, eid, u, v, level, hit);
+                        }
+                    }
+                    frontier.swap(next);
+                    frontier_mask.resize(frontier.size());
+                    for (size_t i = 0; i < frontier.size(); ++i)
+                    {
+                        frontier_mask[i] = next_mask[frontier[i]];
+                        next_mask[frontier[i]] = 0;
+                    }
+                    if (level_mask)
+                        level_masks.push_back(level_mask);
+                }
+
+                on_batch(t, b, lanes, level_masks);
+                for (int v : touched)
+                    active[v] = 0;
+            }
+        });
+    }
+
+};
+
+#endif // WORLD_STORE_H
@@ -35,6 +35,19 @@ CORS(app, resources={r"/api/*": {"origins": allowed_origins}})
 # 在真实的生产环境中，您应该使用Redis或类似的持久化缓存来代替
 computation_cache = {}
 
+
+def parse_edges(items):
+    """将请求中的边列表（{"source": u, "target": v} 或 [u, v]）转换为 C++ 的 Edge 列表。"""
+    edges = []
+    for item in items or []:
+        edge = imm_calculator.Edge()
+        if isinstance(item, dict):
+            edge.source, edge.target = int(item["source"]), int(item["target"])
+        else:
+            edge.source, edge.target = int(item[0]), int(item[1])
+        edges.append(edge)
+    return edges
+
 @app.route('/api/influence/run', methods=['POST'])
 def run_influence_task():
     """
@@ -59,6 +72,15 @@ def run_influence_task():
         # 如果前端未提供模式，则默认为 "RANDOM"
         req.params.neg_num = params_data.get("neg_num", 10) # 假设默认10个
         req.params.seed_generation_mode = params_data.get("seed_generation_mode", "RANDOM")
+        # 最小化模式下自适应采样的相对误差
+        req.params.relative_error = params_data.get("relative_error", 0.1)
+        # 阻塞节点选择引擎: "RR" (默认) 或 "DOMINATOR"
+        req.params.blocking_engine = params_data.get("blocking_engine", "RR")
+        # 阻塞对象: "NODE" (默认, 阻塞节点) 或 "EDGE" (删除边)
+        req.params.blocking_type = params_data.get("blocking_type", "NODE")
+        # 自适应蒙特卡洛的允许误差与置信水平
+        req.params.mc_error = params_data.get("mc_error", 0.02)
+        req.params.mc_confidence = params_data.get("mc_confidence", 0.95)
 
         print(f"接收到请求: mode={req.mode}, dataset={req.dataset_id}, k={req.params.budget}")
 
@@ -87,7 +109,8 @@ def run_influence_task():
                 "main_propagation_paths": [
                     {"source": edge.source, "target": edge.target} 
                     for edge in result.main_propagation_paths
-                ]
+                ],
+                "simulations_used": result.simulations_used
             }
             # --- 【修改结束】 ---
             
@@ -127,7 +150,8 @@ def run_influence_task():
                 "propagation_model": req.params.propagation_model,
                 "probability_model": req.params.probability_model,
                 "initial_nodes": result.seed_nodes,  # <-- 修正
-                "blocking_nodes": [node['id'] for node in blocking_nodes_list_of_dicts]
+                "blocking_nodes": [node['id'] for node in blocking_nodes_list_of_dicts],
+                "blocking_edges": list(result.blocking_edges)
             }
             computation_cache[result.blocked_result_id] = cache_payload_after
 
@@ -137,6 +161,10 @@ def run_influence_task():
                 "blocked_result_id": result.blocked_result_id,
                 "seed_nodes": result.seed_nodes, # <-- 修正: 将实际种子节点返回给前端
                 "blocking_nodes": blocking_nodes_list_of_dicts,
+                "blocking_edges": [
+                    {"source": edge.source, "target": edge.target}
+                    for edge in result.blocking_edges
+                ],
                 "influence_before": {
                     "count": result.influence_before.count, 
                     "ratio": result.influence_before.ratio 
@@ -147,6 +175,10 @@ def run_influence_task():
                 },
                 "reduction_ratio": result.reduction_ratio,
                 "cut_off_paths": cut_off_paths_list_of_dicts,
+                "rr_sample_size": result.rr_sample_size,
+                "sample_confidence": result.sample_confidence,
+                "simulations_before": result.simulations_before,
+                "simulations_after": result.simulations_after,
                 "message": result.message
             }
             
@@ -175,6 +207,7 @@ def get_final_influence_state(result_id):
         # 【【【核心修改】】】
         # 从缓存中获取阻塞节点，如果不存在则默认为空列表
         blocking_nodes = cached_data.get("blocking_nodes", [])
+        blocking_edges = cached_data.get("blocking_edges", [])
 
         # 调用我们修改后的、带有 blocking_nodes 参数的 C++ 函数
         result = imm_calculator.get_final_influence(
@@ -182,7 +215,8 @@ def get_final_influence_state(result_id):
             propagation_model=cached_data["propagation_model"],
             probability_model=cached_data["probability_model"],
             initial_nodes=cached_data["initial_nodes"],
-            blocking_nodes=blocking_nodes # 【传入】
+            blocking_nodes=blocking_nodes, # 【传入】
+            blocking_edges=blocking_edges
         )
 
         # 【核心修改】根据新的 FinalInfluenceResult 结构体来构建JSON响应
@@ -228,6 +262,7 @@ def get_probability_animation_steps(result_id):
         prob_model = cached_data["probability_model"]
         initial_nodes = cached_data["initial_nodes"]
         blocking_nodes = cached_data.get("blocking_nodes", [])
+        blocking_edges = cached_data.get("blocking_edges", [])
 
         # 1. 调用C++获取完整的、原始的动画数据
         result = imm_calculator.get_probability_animation(
@@ -235,7 +270,8 @@ def get_probability_animation_steps(result_id):
             prop_model,
             prob_model,
             initial_nodes,
-            blocking_nodes
+            blocking_nodes,
+            blocking_edges
         )
 
         # ====================================================================
@@ -298,8 +334,10 @@ def get_probability_animation_steps(result_id):
 @app.route('/api/influence/analysis/kl-core', methods=['POST'])
 def run_kl_core_analysis():
     """
-    从零开始，根据给定的参数和种子生成模式，运行(k,l)-core社区发现。
-    不再需要 result_id。
+    根据给定的参数和种子生成模式，运行(k,l)-core社区发现。
+    可选 result_id：传入此前社区分析接口返回的 result_id 时，复用其种子与最终影响状态（数据集与模型需一致），
+    只重新搜索社区，调整 k/l 或切换社区类型时不再重新计算。（/api/influence/run 返回的 result_id 不能在此使用。）
+    返回的 result_id 即为这次分析的流水线ID，供后续社区分析请求复用。
     """
     json_data = request.get_json()
     if not json_data:
@@ -315,6 +353,8 @@ def run_kl_core_analysis():
         seed_budget = json_data.get("seed_budget", 10)
         seed_generation_mode = json_data.get("seed_generation_mode", "RANDOM")
         manual_seeds = json_data.get("seed_nodes", [])
+        # 此前社区分析返回的 result_id；非空时忽略种子相关参数
+        result_id = json_data.get("result_id", "")
 
         if not all([dataset_id, propagation_model, probability_model]) or k_core is None or l_core is None:
             return jsonify({"error": "Missing required parameters"}), 400
@@ -330,11 +370,13 @@ def run_kl_core_analysis():
             l_core=l_core,
             seed_budget=seed_budget,
             seed_generation_mode=seed_generation_mode,
-            manual_seeds=manual_seeds
+            manual_seeds=manual_seeds,
+            result_id=result_id
         )
 
         # 封装和返回结果的逻辑不变
         response_data = {
+            # 流水线ID：作为 result_id 传回社区分析接口即可复用本次的种子与最终状态
             "result_id": community_analysis_result.result_id,
             "community": {
                 "node_ids": community_analysis_result.community.node_ids,
@@ -362,7 +404,8 @@ def run_kl_core_analysis():
 @app.route('/api/influence/analysis/k-core', methods=['POST'])
 def run_k_core_analysis():
     """
-    从零开始，根据给定的参数和种子生成模式，运行k-core社区发现。
+    根据给定的参数和种子生成模式，运行k-core社区发现。
+    可选 result_id 的含义与 /api/influence/analysis/kl-core 相同（复用此前社区分析的种子与最终影响状态）。
     """
     json_data = request.get_json()
     if not json_data: return jsonify({"error": "Invalid JSON"}), 400
@@ -375,6 +418,8 @@ def run_k_core_analysis():
         seed_budget = json_data.get("seed_budget", 10)
         seed_generation_mode = json_data.get("seed_generation_mode", "RANDOM")
         manual_seeds = json_data.get("seed_nodes", [])
+        # 此前社区分析返回的 result_id；非空时忽略种子相关参数
+        result_id = json_data.get("result_id", "")
 
         if not all([dataset_id, propagation_model, probability_model]) or k_core is None:
             return jsonify({"error": "Missing required parameters."}), 400
@@ -389,10 +434,12 @@ def run_k_core_analysis():
             k_core=k_core,
             seed_budget=seed_budget,
             seed_generation_mode=seed_generation_mode,
-            manual_seeds=manual_seeds
+            manual_seeds=manual_seeds,
+            result_id=result_id
         )
 
         response_data = {
+            # 流水线ID：作为 result_id 传回社区分析接口即可复用本次的种子与最终状态
             "result_id": community_analysis_result.result_id,
             "community": {
                 "node_ids": community_analysis_result.community.node_ids,
@@ -420,7 +467,8 @@ def run_k_core_analysis():
 @app.route('/api/influence/analysis/k-truss', methods=['POST'])
 def run_k_truss_analysis():
     """
-    从零开始，根据给定的参数和种子生成模式，运行k-truss社区发现。
+    根据给定的参数和种子生成模式，运行k-truss社区发现。
+    可选 result_id 的含义与 /api/influence/analysis/kl-core 相同（复用此前社区分析的种子与最终影响状态）。
     """
     json_data = request.get_json()
     if not json_data: return jsonify({"error": "Invalid JSON"}), 400
@@ -433,6 +481,8 @@ def run_k_truss_analysis():
         seed_budget = json_data.get("seed_budget", 10)
         seed_generation_mode = json_data.get("seed_generation_mode", "RANDOM")
         manual_seeds = json_data.get("seed_nodes", [])
+        # 此前社区分析返回的 result_id；非空时忽略种子相关参数
+        result_id = json_data.get("result_id", "")
 
         if not all([dataset_id, propagation_model, probability_model]) or k_truss is None:
             return jsonify({"error": "Missing required parameters."}), 400
@@ -449,10 +499,12 @@ def run_k_truss_analysis():
             k_truss=k_truss,
             seed_budget=seed_budget,
             seed_generation_mode=seed_generation_mode,
-            manual_seeds=manual_seeds
+            manual_seeds=manual_seeds,
+            result_id=result_id
         )
 
         response_data = {
+            # 流水线ID：作为 result_id 传回社区分析接口即可复用本次的种子与最终状态
             "result_id": community_analysis_result.result_id,
             "community": {
                 "node_ids": community_analysis_result.community.node_ids,
@@ -476,6 +528,145 @@ def run_k_truss_analysis():
         traceback.print_exc()
         return jsonify({"error": str(e)}), 500
 
+@app.route('/api/influence/analysis/influential-community', methods=['POST'])
+def run_influential_community_analysis():
+    """
+    在 k-core（constraint_type = "K_CORE"）或 k-truss（"K_TRUSS"）约束下，
+    查找包含种子的、平均影响概率最大的连通社区。
+    可选 result_id 的含义与 /api/influence/analysis/kl-core 相同（复用此前社区分析的种子与最终影响状态）。
+    """
+    json_data = request.get_json()
+    if not json_data: return jsonify({"error": "Invalid JSON"}), 400
+
+    try:
+        dataset_id = json_data.get("dataset_id")
+        propagation_model = json_data.get("propagation_model")
+        probability_model = json_data.get("probability_model")
+        constraint_type = json_data.get("constraint_type", "K_CORE")
+        k = json_data.get("k")
+        seed_budget = json_data.get("seed_budget", 10)
+        seed_generation_mode = json_data.get("seed_generation_mode", "RANDOM")
+        manual_seeds = json_data.get("seed_nodes", [])
+        result_id = json_data.get("result_id", "")
+
+        if not all([dataset_id, propagation_model, probability_model]) or k is None:
+            return jsonify({"error": "Missing required parameters."}), 400
+        if constraint_type not in ("K_CORE", "K_TRUSS"):
+            return jsonify({"error": "constraint_type 必须为 K_CORE 或 K_TRUSS"}), 400
+
+        print(f"开始最大影响社区分析 (constraint={constraint_type}, k={k}, seed_mode={seed_generation_mode})...")
+
+        community_analysis_result = imm_calculator.run_influential_community_analysis_from_scratch(
+            dataset_id=dataset_id,
+            propagation_model=propagation_model,
+            probability_model=probability_model,
+            constraint_type=constraint_type,
+            k=k,
+            seed_budget=seed_budget,
+            seed_generation_mode=seed_generation_mode,
+            manual_seeds=manual_seeds,
+            result_id=result_id
+        )
+
+        response_data = {
+            "result_id": community_analysis_result.result_id,
+            "community": {
+                "node_ids": community_analysis_result.community.node_ids,
+                "average_influence_prob": community_analysis_result.community.average_influence_prob,
+                "node_count": community_analysis_result.community.node_count
+            },
+            "message": community_analysis_result.message,
+            "final_states": [
+                {"id": ns.id, "state": ns.state, "probability": ns.probability}
+                for ns in community_analysis_result.final_states
+            ],
+            "seed_nodes": community_analysis_result.seed_nodes
+        }
+
+        print("最大影响社区分析完成。")
+        return jsonify(response_data)
+
+    except Exception as e:
+        import traceback
+        print(f"最大影响社区分析过程中发生错误: {e}")
+        traceback.print_exc()
+        return jsonify({"error": str(e)}), 500
+
+@app.route('/api/influence/analysis/community-batch', methods=['POST'])
+def run_community_batch_analysis():
+    """
+    批量社区分析：以全部种子为查询节点只做一次剥离，返回每个种子所在的社区（相同的社区只返回一次）。
+    community_type 为 "KL_CORE"（使用 k、l）、"K_CORE" 或 "K_TRUSS"（只使用 k）。
+    可选 result_id 的含义与 /api/influence/analysis/kl-core 相同（复用此前社区分析的种子与最终影响状态）。
+    返回中 community_of_query[i] 为 query_nodes[i] 所在社区在 communities 中的下标（没有社区时为 -1），
+    community_queries[j] 为第 j 个社区包含的查询节点。
+    """
+    json_data = request.get_json()
+    if not json_data: return jsonify({"error": "Invalid JSON"}), 400
+
+    try:
+        dataset_id = json_data.get("dataset_id")
+        propagation_model = json_data.get("propagation_model")
+        probability_model = json_data.get("probability_model")
+        community_type = json_data.get("community_type", "KL_CORE")
+        k = json_data.get("k")
+        l = json_data.get("l", 0)
+        seed_budget = json_data.get("seed_budget", 10)
+        seed_generation_mode = json_data.get("seed_generation_mode", "RANDOM")
+        manual_seeds = json_data.get("seed_nodes", [])
+        result_id = json_data.get("result_id", "")
+
+        if not all([dataset_id, propagation_model, probability_model]) or k is None:
+            return jsonify({"error": "Missing required parameters."}), 400
+        if community_type not in ("KL_CORE", "K_CORE", "K_TRUSS"):
+            return jsonify({"error": "community_type 必须为 KL_CORE、K_CORE 或 K_TRUSS"}), 400
+
+        print(f"开始批量社区分析 (type={community_type}, k={k}, l={l}, seed_mode={seed_generation_mode})...")
+
+        batch_result = imm_calculator.run_community_batch_analysis_from_scratch(
+            dataset_id=dataset_id,
+            propagation_model=propagation_model,
+            probability_model=probability_model,
+            community_type=community_type,
+            k=k,
+            l=l,
+            seed_budget=seed_budget,
+            seed_generation_mode=seed_generation_mode,
+            manual_seeds=manual_seeds,
+            result_id=result_id
+        )
+
+        batch = batch_result.batch
+        response_data = {
+            "result_id": batch_result.result_id,
+            "communities": [
+                {
+                    "node_ids": community.node_ids,
+                    "average_influence_prob": community.average_influence_prob,
+                    "node_count": community.node_count
+                }
+                for community in batch.communities
+            ],
+            "community_queries": batch.community_queries,
+            "query_nodes": batch.query_nodes,
+            "community_of_query": batch.community_of_query,
+            "message": batch_result.message,
+            "final_states": [
+                {"id": ns.id, "state": ns.state, "probability": ns.probability}
+                for ns in batch_result.final_states
+            ],
+            "seed_nodes": batch_result.seed_nodes
+        }
+
+        print("批量社区分析完成。")
+        return jsonify(response_data)
+
+    except Exception as e:
+        import traceback
+        print(f"批量社区分析过程中发生错误: {e}")
+        traceback.print_exc()
+        return jsonify({"error": str(e)}), 500
+
 # ... (所有其他函数，如 get_blocking_animation_endpoint, run_critical_path_analysis 等保持不变) ...
 # 【替换】现有的 get_blocking_animation_endpoint 函数
 @app.route('/api/influence/blocking-animation', methods=['POST'])
@@ -503,7 +694,9 @@ def get_blocking_animation_endpoint():
             propagation_model=cached_data["propagation_model"],
             probability_model=cached_data["probability_model"],
             initial_nodes=cached_data.get("initial_nodes", []),
-            blocking_nodes=cached_data_after.get("blocking_nodes", [])
+            blocking_nodes=cached_data_after.get("blocking_nodes", []),
+            # 边阻塞模式下阻塞节点为空，动画按删除的边逐步展示
+            blocking_edges=cached_data_after.get("blocking_edges", [])
         )
 
         # 转换并返回结果 (这部分逻辑不变)
@@ -533,14 +726,20 @@ def get_blocking_animation_endpoint():
 def run_critical_path_analysis(result_id):
     """
     根据给定的分析类型，找到关键传播路径。
+    type 为 "deepest"（出现过的最深传播路径）或 "most_probable"（经验概率最大的前 top_k 条传播路径）。
+    两种类型都返回传播样本数、传播深度分布和平均深度。
     """
     if result_id not in computation_cache:
         return jsonify({"error": "Result ID not found or has expired."}), 404
 
     json_data = request.get_json()
+    if not json_data: return jsonify({"error": "Invalid JSON"}), 400
     analysis_type = json_data.get("type")
-    if analysis_type != "deepest":
-        return jsonify({"error": "Invalid analysis type. Currently only 'deepest' is supported."}), 400
+    if analysis_type not in ("deepest", "most_probable"):
+        return jsonify({"error": "Invalid analysis type. Supported types are 'deepest' and 'most_probable'."}), 400
+    top_k = json_data.get("top_k", 5)
+    if not isinstance(top_k, int) or top_k < 1:
+        return jsonify({"error": "top_k 必须为正整数"}), 400
 
     try:
         cached_data = computation_cache[result_id]
@@ -551,21 +750,27 @@ def run_critical_path_analysis(result_id):
             cached_data["dataset_id"],
             cached_data["propagation_model"],
             cached_data["probability_model"],
-            cached_data["initial_nodes"]
+            cached_data["initial_nodes"],
+            top_k
         )
 
-        # 转换并返回结果
+        # 转换并返回结果（只保留请求的路径类型）
         response_data = {
             "result_id": path_result.result_id,
             "critical_paths": [
                 {
                     "nodes": path.nodes,
                     "score": path.score,
-                    "type": path.type
+                    "type": path.type,
+                    "probability": path.probability
                 }
                 for path in path_result.critical_paths
+                if path.type == analysis_type
             ],
-            "message": path_result.message
+            "message": path_result.message,
+            "num_samples": path_result.num_samples,
+            "depth_distribution": path_result.depth_distribution,
+            "mean_depth": path_result.mean_depth
         }
         return jsonify(response_data)
 
@@ -594,6 +799,11 @@ def calculate_influence_from_nodes():
         # 种子节点和阻塞节点现在都是可选的
         seed_nodes = json_data.get("seed_nodes", [])
         blocking_nodes = json_data.get("blocking_nodes", [])
+        # 删除的边: [{"source": u, "target": v}, ...]
+        blocking_edges = parse_edges(json_data.get("blocking_edges", []))
+        # 估计方式: "MC" (默认, 返回逐节点概率), "RR" (只返回期望激活节点数, 速度更快)
+        # 或 "PMC" (缩点后的 IC 世界, 返回逐节点概率)
+        estimator = json_data.get("estimator", "MC")
 
         if not all([dataset_id, propagation_model, probability_model]):
             return jsonify({"error": "Missing one or more required parameters (dataset_id, propagation_model, probability_model)."}), 400
@@ -604,7 +814,9 @@ def calculate_influence_from_nodes():
             propagation_model=propagation_model,
             probability_model=probability_model,
             initial_nodes=seed_nodes,
-            blocking_nodes=blocking_nodes 
+            blocking_nodes=blocking_nodes,
+            blocking_edges=blocking_edges,
+            estimator=estimator
         )
 
         # 封装并返回与 /api/influence/final-state/<result_id> 格式一致的结果
@@ -623,6 +835,68 @@ def calculate_influence_from_nodes():
         traceback.print_exc()
         return jsonify({"error": str(e)}), 500
 
+@app.route('/api/influence/batch-spread', methods=['POST'])
+def evaluate_spread_batch():
+    """
+    批量评估多个 (种子, 阻塞) 组合的影响力。所有组合共享同一张图和同一批预采样世界
+    (或 RR 集池)，适用于候选方案对比与筛选。include_states 为 true 时返回每个组合的逐节点概率。
+    每个查询可以给出 blocking_nodes 和/或 blocking_edges（[{"source": u, "target": v}, ...]）。
+    """
+    json_data = request.get_json()
+    if not json_data:
+        return jsonify({"error": "Invalid JSON"}), 400
+
+    try:
+        dataset_id = json_data.get("dataset_id")
+        propagation_model = json_data.get("propagation_model")
+        probability_model = json_data.get("probability_model")
+        include_states = json_data.get("include_states", False)
+        # 估计方式: "MC" (默认), "RR" 或 "PMC"
+        estimator = json_data.get("estimator", "MC")
+
+        if not all([dataset_id, propagation_model, probability_model]):
+            return jsonify({"error": "Missing one or more required parameters (dataset_id, propagation_model, probability_model)."}), 400
+
+        queries = []
+        for item in json_data.get("queries", []):
+            query = imm_calculator.SpreadQuery()
+            query.seed_nodes = item.get("seed_nodes", [])
+            query.blocking_nodes = item.get("blocking_nodes", [])
+            query.blocking_edges = parse_edges(item.get("blocking_edges", []))
+            queries.append(query)
+
+        result = imm_calculator.evaluate_spread_batch(
+            dataset_id=dataset_id,
+            propagation_model=propagation_model,
+            probability_model=probability_model,
+            queries=queries,
+            include_states=include_states,
+            estimator=estimator
+        )
+
+        response_data = {
+            "result_id": result.result_id,
+            "num_worlds": result.num_worlds,
+            "results": [
+                {
+                    "total_influence": r.total_influence,
+                    "active_count": r.active_count,
+                    "final_states": [
+                        {"id": ns.id, "state": ns.state, "probability": ns.probability}
+                        for ns in r.final_states
+                    ]
+                }
+                for r in result.results
+            ],
+            "message": result.message
+        }
+        return jsonify(response_data)
+
+    except Exception as e:
+        import traceback
+        traceback.print_exc()
+        return jsonify({"error": str(e)}), 500
+
 if __name__ == '__main__':
     # 监听所有网络接口，端口为5001
     app.run(host='0.0.0.0', port=5019, debug=True)
\ No newline at end of file